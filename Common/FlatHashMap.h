@@ -0,0 +1,257 @@
+/**
+ * @file FlatHashMap.h
+ *  This file defines a FlatHashMap class, an open addressing
+ *  hash map from 64 bit keys to integers, along with helpers
+ *  to pack an operator and two set identifiers into such a
+ *  key.
+ **/
+
+#ifndef FLATHASHMAP_H
+#define FLATHASHMAP_H
+
+#include<cassert>
+#include<cstdint>
+#include<vector>
+
+/**
+ * @brief
+ *  Packs an operator and two set identifiers into a 64 bit key.
+ *
+ * @details
+ *  The operator takes the highest 8 bits and each of the set
+ *  identifiers takes 28 bits. This is the key used for the
+ *  `Parent` map.
+ *
+ * @param   op      Operator of the expression
+ * @param   left    Set identifier of the left operand
+ * @param   right   Set identifier of the right operand
+ * @returns         The packed key
+ **/
+inline uint64_t packKey(char op, int left, int right) {
+    assert(left >= 0 && left < (1 << 28) && "Set identifier out of range");
+    assert(right >= 0 && right < (1 << 28) && "Set identifier out of range");
+    return ((uint64_t)(unsigned char)op << 56) | ((uint64_t)left << 28) |
+           (uint64_t)right;
+}
+
+/**
+ * @brief   Extracts the operator from a key made by `packKey`.
+ **/
+inline char keyOp(uint64_t key) { return (char)(key >> 56); }
+
+/**
+ * @brief   Extracts the left set identifier from a key made by `packKey`.
+ **/
+inline int keyLeft(uint64_t key) { return (int)((key >> 28) & ((1 << 28) - 1)); }
+
+/**
+ * @brief   Extracts the right set identifier from a key made by `packKey`.
+ **/
+inline int keyRight(uint64_t key) { return (int)(key & ((1 << 28) - 1)); }
+
+/**
+ * @struct FlatHashMap
+ * @brief
+ *  Open addressing hash map from 64 bit keys to non-negative
+ *  integers.
+ *
+ * @details
+ *  Keys and values are stored in two flat vectors whose size
+ *  is a power of two, collisions are resolved by linear probing
+ *  and the table is doubled whenever it gets half full. Entries
+ *  can not be erased individually, which is all the `Parent` map
+ *  needs. The all ones key is reserved to mark empty slots.
+ **/
+class FlatHashMap {
+public:
+    using key_type = uint64_t;
+    using size_type = std::vector<key_type>::size_type;
+
+    /**
+     * @brief   Key used to mark empty slots.
+     *
+     * @note
+     *  It is copied with `key_type(EmptyKey)` wherever it would
+     *  bind to a reference, as before C++17 that needs a definition
+     *  outside the class.
+     **/
+    static constexpr key_type EmptyKey = ~(key_type)0;
+
+    /**
+     * @brief   Constructor for FlatHashMap class.
+     **/
+    FlatHashMap() : Keys(16, key_type(EmptyKey)), Values(16, -1), Size(0) {}
+
+    /**
+     * @brief Method to return whether the object is empty.
+     *
+     * @returns     True if the object does not contain any key
+     *              otherwise false
+     **/
+    bool empty() const { return Size == 0; }
+
+    /**
+     * @brief
+     *  Method to return the number of keys in the object.
+     *
+     * @returns     The number of keys
+     **/
+    size_type size() const { return Size; }
+
+    /**
+     * @brief
+     *  Method to return the number of slots in the table.
+     *
+     * @returns     The number of slots
+     **/
+    size_type capacity() const { return Keys.size(); }
+
+    /**
+     * @brief
+     *  Method to return the number of bytes allocated by the object.
+     *
+     * @returns     The bytes held by the table
+     **/
+    size_type memoryUsage() const {
+        return Keys.capacity() * sizeof(key_type) + Values.capacity() * sizeof(int);
+    }
+
+    /**
+     * @brief Method to look up a key.
+     *
+     * @param   key     The key to be looked up
+     *
+     * @returns     The value corresponding to the key if it is
+     *              present otherwise -1
+     **/
+    int find(key_type key) const {
+        size_type mask = Keys.size() - 1;
+        for(size_type slot = hash(key) & mask; ; slot = (slot + 1) & mask) {
+            if(Keys[slot] == key) return Values[slot];
+            if(Keys[slot] == EmptyKey) return -1;
+        }
+    }
+
+    /**
+     * @brief Method to insert a new key.
+     *
+     * @param   key     The key to be inserted
+     * @param   value   The value for the key
+     *
+     * @returns     A std::pair object whose first element is the value
+     *              now mapped to the key and whose second element is a
+     *              boolean indicating whether the key was inserted or
+     *              not (if it was already present, in which case its
+     *              value is left unchanged)
+     **/
+    std::pair<int, bool> insert(key_type key, int value) {
+        assert(key != EmptyKey && "Reserved key inserted");
+
+        if(2 * (Size + 1) > Keys.size()) grow();
+
+        size_type slot = findSlot(key);
+        if(Keys[slot] == key) return {Values[slot], false};
+
+        Keys[slot] = key, Values[slot] = value, Size++;
+        return {value, true};
+    }
+
+    /**
+     * @brief
+     *  Method to map a key to a value, inserting the key if it is
+     *  not present and overwriting its value otherwise.
+     *
+     * @param   key     The key to be mapped
+     * @param   value   The new value for the key
+     *
+     * @returns     None
+     **/
+    void assign(key_type key, int value) {
+        assert(key != EmptyKey && "Reserved key inserted");
+
+        if(2 * (Size + 1) > Keys.size()) grow();
+
+        size_type slot = findSlot(key);
+        if(Keys[slot] != key) Keys[slot] = key, Size++;
+        Values[slot] = value;
+    }
+
+    /**
+     * @brief Calls a function for each key and its value.
+     *
+     * @param   fn  Callable taking a key and a value
+     *
+     * @returns     None
+     **/
+    template<typename Fn>
+    void forEach(Fn fn) const {
+        for(size_type slot = 0; slot < Keys.size(); slot++)
+            if(Keys[slot] != EmptyKey) fn(Keys[slot], Values[slot]);
+    }
+
+    /**
+     * @brief Method to clear the object.
+     *
+     * @returns     None
+     **/
+    void clear() {
+        Keys.assign(16, key_type(EmptyKey)), Values.assign(16, -1);
+        Keys.shrink_to_fit(), Values.shrink_to_fit();
+        Size = 0;
+    }
+
+private:
+    /**
+     * @brief   Keys in the table, empty slots hold `EmptyKey`.
+     **/
+    std::vector<key_type> Keys;
+
+    /**
+     * @brief   Values corresponding to `Keys`.
+     **/
+    std::vector<int> Values;
+
+    /**
+     * @brief   Number of keys in the table.
+     **/
+    size_type Size;
+
+    /**
+     * @brief   Mixes the bits of a key (finaliser of splitmix64).
+     **/
+    static size_type hash(key_type key) {
+        key ^= key >> 30, key *= 0xbf58476d1ce4e5b9ULL;
+        key ^= key >> 27, key *= 0x94d049bb133111ebULL;
+        return (size_type)(key ^ (key >> 31));
+    }
+
+    /**
+     * @brief
+     *  Returns the slot holding a key, or the empty slot where
+     *  it would be inserted.
+     **/
+    size_type findSlot(key_type key) const {
+        size_type mask = Keys.size() - 1;
+        size_type slot = hash(key) & mask;
+        while(Keys[slot] != key && Keys[slot] != EmptyKey)
+            slot = (slot + 1) & mask;
+        return slot;
+    }
+
+    /**
+     * @brief   Doubles the table, rehashing all the keys.
+     **/
+    void grow() {
+        std::vector<key_type> oldKeys(Keys.size() * 2, key_type(EmptyKey));
+        std::vector<int> oldValues(Values.size() * 2, -1);
+        oldKeys.swap(Keys), oldValues.swap(Values);
+
+        for(size_type slot = 0; slot < oldKeys.size(); slot++) {
+            if(oldKeys[slot] == EmptyKey) continue;
+            size_type newSlot = findSlot(oldKeys[slot]);
+            Keys[newSlot] = oldKeys[slot], Values[newSlot] = oldValues[slot];
+        }
+    }
+};
+
+#endif
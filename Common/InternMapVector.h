@@ -0,0 +1,364 @@
+/**
+ * @file InternMapVector.h
+ *  This file defines an InternMapVector class, a variant of
+ *  MapVector backed by an open addressing hash table, which
+ *  interns values as consecutive integers. Strings are stored
+ *  once, in an arena.
+ **/
+
+#ifndef INTERNMAPVECTOR_H
+#define INTERNMAPVECTOR_H
+
+#include<algorithm>
+#include<cassert>
+#include<cstdint>
+#include<functional>
+#include<memory>
+#include<string>
+#include<utility>
+#include<vector>
+#if __cplusplus >= 201703L
+#include<string_view>
+#endif
+
+/**
+ * @struct InternTraits
+ * @brief
+ *  How an `InternMapVector` hashes and stores its values.
+ *
+ * @details
+ *  Values are hashed with `std::hash` and kept as they are.
+ *
+ * @tparam  T   Any type for which `std::hash` is defined
+ **/
+template<typename T>
+struct InternTraits {
+    /**
+     * @brief   Type of the values kept and looked up.
+     **/
+    using value_type = T;
+
+    /**
+     * @brief   Hashes a value.
+     **/
+    static uint64_t hash(value_type const &el) { return std::hash<T>()(el); }
+
+    /**
+     * @brief   Storage of the values, which keeps nothing.
+     **/
+    struct StorageTy {
+        /**
+         * @brief   Returns the value to be kept for a value inserted.
+         **/
+        value_type store(value_type const &el) { return el; }
+
+        /**
+         * @brief   Drops everything stored.
+         **/
+        void clear() {}
+
+        /**
+         * @brief   Returns the bytes allocated for the values stored.
+         **/
+        size_t memoryUsage() const { return 0; }
+    };
+};
+
+#if __cplusplus >= 201703L
+/**
+ * @brief
+ *  Strings are kept as `std::string_view`s into an arena of large
+ *  blocks, which are never moved, so the bytes of a string are
+ *  copied once, when it is inserted.
+ **/
+template<>
+struct InternTraits<std::string> {
+    using value_type = std::string_view;
+
+    /**
+     * @brief   FNV-1a hash of a string.
+     **/
+    static uint64_t hash(value_type el) {
+        uint64_t h = 0xcbf29ce484222325ULL;
+        for(char ch : el) h = (h ^ (unsigned char)ch) * 0x100000001b3ULL;
+        return h;
+    }
+
+    /**
+     * @brief   Arena holding the bytes of the strings.
+     **/
+    class StorageTy {
+    public:
+        StorageTy() : Used(0), Size(0), Allocated(0) {}
+
+        /**
+         * @brief   Copies a string into the arena and returns the copy.
+         **/
+        value_type store(value_type el) {
+            if(el.empty()) return value_type();
+            if(el.size() > Size - Used) {
+                Size = std::max<size_t>(1 << 16, el.size());
+                Blocks.emplace_back(new char[Size]);
+                Used = 0, Allocated += Size;
+            }
+            char *bytes = Blocks.back().get() + Used;
+            std::char_traits<char>::copy(bytes, el.data(), el.size());
+            Used += el.size();
+            return value_type(bytes, el.size());
+        }
+
+        /**
+         * @brief   Frees the arena.
+         **/
+        void clear() { Blocks.clear(), Used = Size = Allocated = 0; }
+
+        /**
+         * @brief   Returns the bytes allocated for the arena.
+         **/
+        size_t memoryUsage() const {
+            return Allocated + Blocks.capacity() * sizeof(std::unique_ptr<char[]>);
+        }
+
+    private:
+        /**
+         * @brief   Blocks of the arena.
+         **/
+        std::vector<std::unique_ptr<char[]>> Blocks;
+
+        /**
+         * @brief   Bytes used and size of the last block.
+         **/
+        size_t Used, Size;
+
+        /**
+         * @brief   Total size of the blocks.
+         **/
+        size_t Allocated;
+    };
+};
+#endif
+
+/**
+ * @struct InternMapVector
+ * @brief
+ *  Open addressing hash table mapping values to consecutive integers,
+ *  in the order they are first inserted, and back.
+ *
+ * @tparam  T   Any type for which `std::hash` is defined
+ *
+ * @details
+ *  Provides the same methods as `MapVector`. The integers are never
+ *  changed and are indexes into a vector of the values, so reverse
+ *  mapping is a single access. Each slot of the table holds a 32 bit
+ *  hash of its value next to its integer, so that a probe compares
+ *  values only when the hashes match and growing the table does not
+ *  hash the values again. Collisions are resolved by linear probing
+ *  and the table is doubled whenever it gets half full.
+ *
+ *  For `std::string` (from C++17) the bytes of the strings are
+ *  copied once into an arena, and the values are `std::string_view`s
+ *  into it. Strings are looked up and inserted as `std::string_view`s,
+ *  so a string is copied only when it is new.
+ *
+ * @see InternTraits, MapVector
+ **/
+template<typename T>
+class InternMapVector {
+public:
+    // declarations for better readability
+    using value_type = typename InternTraits<T>::value_type;
+    using const_reference = const value_type&;
+    using vector_type = typename std::vector<value_type>;
+    using iterator = typename vector_type::const_iterator;
+    using const_iterator = typename vector_type::const_iterator;
+    using reverse_iterator = typename vector_type::const_reverse_iterator;
+    using const_reverse_iterator = typename vector_type::const_reverse_iterator;
+    using size_type = typename vector_type::size_type;
+
+    // Methods to return iterators for the class. These are the
+    // corresponding iterators to the underlying Vector data member
+    iterator begin() const { return Vector.begin(); }
+    iterator end() const { return Vector.end(); }
+    reverse_iterator rbegin() const { return Vector.rbegin(); }
+    reverse_iterator rend() const { return Vector.rend(); }
+
+    /**
+     * @brief   Constructor for InternMapVector class.
+     **/
+    InternMapVector() : Slots(16, SlotTy{0, -1}) {}
+
+    // the values kept may point into the storage of the object
+    InternMapVector(InternMapVector const &other) : InternMapVector() { *this = other; }
+    InternMapVector &operator=(InternMapVector const &other) {
+        if(this == &other) return *this;
+        clear();
+        for(auto &el : other) insert(el);
+        return *this;
+    }
+    InternMapVector(InternMapVector &&) = default;
+    InternMapVector &operator=(InternMapVector &&) = default;
+
+    /**
+     * @brief Method to return whether the object is empty.
+     *
+     * @returns     True if the object does not contain any value
+     *              otherwise false
+     **/
+    bool empty() const { return Vector.empty(); }
+
+    /**
+     * @brief
+     *  Method to return the size of the object - the number of
+     *  distinct values added to the object.
+     *
+     * @returns     The number of distinct values added to the
+     *              object
+     **/
+    size_type size() const { return Vector.size(); }
+
+    /**
+     * @brief
+     *  Method to return the number of bytes allocated by the object,
+     *  for the table, the vector of values and the storage of the
+     *  values.
+     *
+     * @returns     The bytes held by the object
+     **/
+    size_t memoryUsage() const {
+        return Slots.capacity() * sizeof(SlotTy) + Vector.capacity() * sizeof(value_type) +
+               Storage.memoryUsage();
+    }
+
+    /**
+     * @brief Method used for forward mapping.
+     *
+     * @param   el  Value to be forward mapped
+     *
+     * @returns     The index corresponding to the value if it is
+     *              already present otherwise -1
+     **/
+    int getInt(const_reference el) const {
+        return Slots[findSlot(el, hash(el))].Id;
+    }
+
+    /**
+     * @brief
+     *  The operator is overloaded for reverse mapping. The method
+     *  checks for range overflows in debug builds.
+     *
+     * @param   n   The index to be reverse mapped
+     *
+     * @returns     The value corresponding to the index
+     **/
+    const_reference operator[](size_type n) const {
+        assert(n < Vector.size() && "InternMapVector access out of range");
+        return Vector[n];
+    }
+
+    /**
+     * @brief Method to insert a new value.
+     *
+     * @param   el  The value to be inserted
+     *
+     * @returns     A std::pair object whose second element is a boolean
+     *              indicating whether the value was inserted or not (if
+     *              it was already inserted before) and the index to which
+     *              it has been mapped
+     **/
+    std::pair<int, bool> insert(const_reference el) {
+        if(2 * (Vector.size() + 1) > Slots.size()) grow();
+
+        uint32_t h = hash(el);
+        SlotTy &slot = Slots[findSlot(el, h)];
+        if(slot.Id != -1) return {slot.Id, false};
+
+        slot = {h, (int)Vector.size()};
+        Vector.push_back(Storage.store(el));
+        return {slot.Id, true};
+    }
+
+    /**
+     * @brief Method to clear the object.
+     *
+     * @returns     None
+     **/
+    void clear() {
+        Slots.assign(16, SlotTy{0, -1});
+        Vector.clear();
+        Storage.clear();
+    }
+
+private:
+    /**
+     * @brief   Slot of the table.
+     **/
+    struct SlotTy {
+        /**
+         * @brief   Hash of the value, see `hash`.
+         **/
+        uint32_t Hash;
+
+        /**
+         * @brief   Index of the value, -1 if the slot is empty.
+         **/
+        int Id;
+    };
+
+    /**
+     * @brief   Slots of the table, their number is a power of two.
+     **/
+    std::vector<SlotTy> Slots;
+
+    /**
+     * @brief   std::vector object for reverse mapping.
+     **/
+    vector_type Vector;
+
+    /**
+     * @brief   Storage of the values, see `InternTraits`.
+     **/
+    typename InternTraits<T>::StorageTy Storage;
+
+    /**
+     * @brief
+     *  Hashes a value and mixes the bits, as `std::hash` of integers
+     *  and pointers is usually the identity.
+     **/
+    static uint32_t hash(const_reference el) {
+        uint64_t h = InternTraits<T>::hash(el);
+        h ^= h >> 33, h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33, h *= 0xc4ceb9fe1a85ec53ULL;
+        return (uint32_t)(h ^ (h >> 33));
+    }
+
+    /**
+     * @brief
+     *  Returns the slot holding a value, or the empty slot where
+     *  it would be inserted.
+     **/
+    size_type findSlot(const_reference el, uint32_t h) const {
+        size_type mask = Slots.size() - 1;
+        size_type slot = h & mask;
+        while(Slots[slot].Id != -1 and (Slots[slot].Hash != h or not (Vector[Slots[slot].Id] == el)))
+            slot = (slot + 1) & mask;
+        return slot;
+    }
+
+    /**
+     * @brief   Doubles the table, placing all the values again.
+     **/
+    void grow() {
+        std::vector<SlotTy> oldSlots(Slots.size() * 2, SlotTy{0, -1});
+        oldSlots.swap(Slots);
+
+        size_type mask = Slots.size() - 1;
+        for(auto &old : oldSlots) {
+            if(old.Id == -1) continue;
+            size_type slot = old.Hash & mask;
+            while(Slots[slot].Id != -1) slot = (slot + 1) & mask;
+            Slots[slot] = old;
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,295 @@
+/**
+ * @file Partition.h
+ *  This file defines a Partition class, an array of set
+ *  identifiers whose copies share storage until they are
+ *  modified.
+ **/
+
+#ifndef PARTITION_H
+#define PARTITION_H
+
+#include<array>
+#include<cassert>
+#include<memory>
+#include<unordered_map>
+#include<unordered_set>
+#include<vector>
+
+/**
+ * @struct Partition
+ * @brief
+ *  Persistent array of set identifiers, one for each expression,
+ *  used to hold the partition at a program point.
+ *
+ * @details
+ *  The entries are stored in leaves of `LeafSize` entries, which
+ *  are grouped into mids of `MidSize` leaves, and the partition
+ *  itself only holds a vector of pointers to its mids. Copying a
+ *  partition copies this vector, sharing all the mids and leaves.
+ *  Modifying an entry first copies its mid and leaf if they are
+ *  shared (copy-on-write), so a partition derived from another by
+ *  changing a few entries costs storage only for the leaves which
+ *  were changed.
+ *
+ * @note
+ *  A partition can be read from many threads, but it must not be
+ *  modified while another thread is reading it. Its copies can be
+ *  modified independently from different threads.
+ **/
+class Partition {
+public:
+    enum {
+        LeafBits = 6, MidBits = 6,
+        LeafSize = 1 << LeafBits, MidSize = 1 << MidBits
+    };
+
+    /**
+     * @brief   Constructor for Partition class, creating an empty array.
+     **/
+    Partition() : Size(0) {}
+
+    /**
+     * @brief
+     *  Constructor for Partition class, creating an array of `size`
+     *  copies of `value`.
+     **/
+    Partition(int size, int value) { assign(size, value); }
+
+    /**
+     * @brief
+     *  Method to replace the contents by `size` copies of `value`.
+     *  All the entries share a single leaf until they are modified.
+     *
+     * @param   size    Number of entries
+     * @param   value   Value of each entry
+     *
+     * @returns     None
+     **/
+    void assign(int size, int value) {
+        Size = size;
+
+        std::shared_ptr<LeafTy> leaf = std::make_shared<LeafTy>();
+        leaf->fill(value);
+        std::shared_ptr<MidTy> mid = std::make_shared<MidTy>();
+        mid->fill(leaf);
+
+        Root.assign((size + MidSize * LeafSize - 1) / (MidSize * LeafSize), mid);
+    }
+
+    /**
+     * @brief Method to return the number of entries.
+     **/
+    int size() const { return Size; }
+
+    /**
+     * @brief Method to read an entry.
+     *
+     * @param   idx     Index of the entry
+     *
+     * @returns     The value of the entry
+     **/
+    int operator[](int idx) const {
+        assert(idx >= 0 && idx < Size && "Partition index out of range");
+        return (*(*Root[idx >> (LeafBits + MidBits)])[(idx >> LeafBits) & (MidSize - 1)])
+               [idx & (LeafSize - 1)];
+    }
+
+    /**
+     * @brief
+     *  Method to modify an entry, copying its mid and leaf first
+     *  if they are shared. Nothing is copied if the entry already
+     *  holds the value.
+     *
+     * @param   idx     Index of the entry
+     * @param   value   New value of the entry
+     *
+     * @returns     None
+     **/
+    void set(int idx, int value) {
+        if((*this)[idx] == value) return;
+
+        std::shared_ptr<MidTy> &mid = Root[idx >> (LeafBits + MidBits)];
+        if(mid.use_count() > 1) mid = std::make_shared<MidTy>(*mid);
+
+        std::shared_ptr<LeafTy> &leaf = (*mid)[(idx >> LeafBits) & (MidSize - 1)];
+        if(leaf.use_count() > 1) leaf = std::make_shared<LeafTy>(*leaf);
+
+        (*leaf)[idx & (LeafSize - 1)] = value;
+    }
+
+    /**
+     * @brief
+     *  Method to return whether two partitions share all their
+     *  storage, in which case they are equal.
+     **/
+    bool sameStorage(Partition const &other) const {
+        return Size == other.Size && Root == other.Root;
+    }
+
+    /**
+     * @brief
+     *  Method to return whether the leaf holding an entry is shared
+     *  by another partition, in which case the two partitions are
+     *  equal on all the entries of the leaf.
+     *
+     * @param   other   The other partition
+     * @param   idx     Index of the entry
+     *
+     * @returns     True if the leaf is shared otherwise false
+     **/
+    bool sameLeaf(Partition const &other, int idx) const {
+        int r = idx >> (LeafBits + MidBits), m = (idx >> LeafBits) & (MidSize - 1);
+        return Root[r] == other.Root[r] || (*Root[r])[m] == (*other.Root[r])[m];
+    }
+
+    /**
+     * @brief
+     *  Method to make the leaf holding an entry shared with another
+     *  partition of the same size, replacing all the entries of the
+     *  leaf by those of the other partition.
+     *
+     * @param   other   The other partition
+     * @param   idx     Index of the entry
+     *
+     * @returns     None
+     **/
+    void shareLeaf(Partition const &other, int idx) {
+        assert(Size == other.Size && "Partitions of different sizes");
+        if(sameLeaf(other, idx)) return;
+
+        int r = idx >> (LeafBits + MidBits), m = (idx >> LeafBits) & (MidSize - 1);
+        if(Root[r].use_count() > 1) Root[r] = std::make_shared<MidTy>(*Root[r]);
+        (*Root[r])[m] = (*other.Root[r])[m];
+    }
+
+    /**
+     * @brief
+     *  Method to call `fn` on the entries of some partitions, 
+     *  visiting the entries of a leaf shared by several of them
+     *  only once. The entries past the end of a partition in its
+     *  last leaf are visited as well.
+     *
+     * @param   partitions  The partitions
+     * @param   fn          Function called with the value of each entry
+     *
+     * @returns     None
+     **/
+    template<typename Fn>
+    static void forEachEntry(std::vector<Partition *> const &partitions, Fn fn) {
+        std::unordered_set<MidTy const *> seenMids;
+        std::unordered_set<LeafTy const *> seenLeaves;
+        for(Partition *partition : partitions)
+            for(auto &mid : partition->Root) {
+                if(not seenMids.insert(mid.get()).second) continue;
+                for(auto &leaf : *mid) {
+                    if(not seenLeaves.insert(leaf.get()).second) continue;
+                    for(int value : *leaf) fn(value);
+                }
+            }
+    }
+
+    /**
+     * @brief
+     *  Method to return the number of bytes allocated by some
+     *  partitions, counting a mid or leaf shared by several of them
+     *  once.
+     *
+     * @details
+     *  Each mid and leaf is counted by its size, without the control
+     *  block of its `std::shared_ptr` and the overhead of `malloc`.
+     *
+     * @param   partitions  The partitions
+     *
+     * @returns     The bytes held by the partitions, without the
+     *              `Partition` objects themselves
+     **/
+    static size_t memoryUsage(std::vector<Partition> const &partitions) {
+        std::unordered_set<MidTy const *> seenMids;
+        std::unordered_set<LeafTy const *> seenLeaves;
+        size_t bytes = 0;
+        for(Partition const &partition : partitions) {
+            bytes += partition.Root.capacity() * sizeof(std::shared_ptr<MidTy>);
+            for(auto &mid : partition.Root) {
+                if(not seenMids.insert(mid.get()).second) continue;
+                bytes += sizeof(MidTy);
+                for(auto &leaf : *mid)
+                    if(seenLeaves.insert(leaf.get()).second) bytes += sizeof(LeafTy);
+            }
+        }
+        return bytes;
+    }
+
+    /**
+     * @brief
+     *  Method to return the least number of bytes `count` partitions
+     *  of `size` entries can take, when they share all their mids
+     *  and leaves.
+     *
+     * @param   size    Number of entries of each partition
+     * @param   count   Number of partitions
+     *
+     * @returns     The bytes, without the `Partition` objects
+     **/
+    static size_t sharedMemoryUsage(int size, int count) {
+        size_t leaves = (size + LeafSize - 1) / LeafSize;
+        size_t mids = (leaves + MidSize - 1) / MidSize;
+        return count * mids * sizeof(std::shared_ptr<MidTy>) + mids * sizeof(MidTy) +
+               leaves * sizeof(LeafTy);
+    }
+
+    /**
+     * @brief
+     *  Method to replace each entry of some partitions by `fn` of
+     *  its value. A mid or leaf shared by several of the partitions
+     *  is replaced only once, so they share their storage just as
+     *  they did before.
+     *
+     * @param   partitions  The partitions, each given once
+     * @param   fn          Function returning the new value of an entry
+     *
+     * @returns     None
+     **/
+    template<typename Fn>
+    static void remap(std::vector<Partition *> const &partitions, Fn fn) {
+        // the replaced mids are kept alive till the end, so that the
+        // address of a replaced mid or leaf is not reused for another
+        std::vector<std::shared_ptr<MidTy>> oldMids;
+        std::unordered_map<MidTy const *, std::shared_ptr<MidTy>> newMids;
+        std::unordered_map<LeafTy const *, std::shared_ptr<LeafTy>> newLeaves;
+
+        for(Partition *partition : partitions)
+            for(auto &mid : partition->Root) {
+                std::shared_ptr<MidTy> &newMid = newMids[mid.get()];
+                if(not newMid) {
+                    newMid = std::make_shared<MidTy>();
+                    for(int m = 0; m < MidSize; m++) {
+                        LeafTy const &leaf = *(*mid)[m];
+                        std::shared_ptr<LeafTy> &newLeaf = newLeaves[&leaf];
+                        if(not newLeaf) {
+                            newLeaf = std::make_shared<LeafTy>();
+                            for(int l = 0; l < LeafSize; l++) (*newLeaf)[l] = fn(leaf[l]);
+                        }
+                        (*newMid)[m] = newLeaf;
+                    }
+                    oldMids.push_back(mid);
+                }
+                mid = newMid;
+            }
+    }
+
+private:
+    typedef std::array<int, LeafSize> LeafTy;
+    typedef std::array<std::shared_ptr<LeafTy>, MidSize> MidTy;
+
+    /**
+     * @brief   Number of entries.
+     **/
+    int Size;
+
+    /**
+     * @brief   Pointers to the mids holding the entries.
+     **/
+    std::vector<std::shared_ptr<MidTy>> Root;
+};
+
+#endif
@@ -0,0 +1,559 @@
+/**
+ * @file ResultFile.h
+ *  This file defines the binary format in which the partitions
+ *  at the program points are saved once the fixpoint has been
+ *  computed, along with a function writing such a file and a
+ *  ResultFile class reading it through a memory mapping. The
+ *  same files make up the cache of results kept across runs.
+ **/
+
+#ifndef RESULTFILE_H
+#define RESULTFILE_H
+
+#include"Partition.h"
+#include<algorithm>
+#include<atomic>
+#include<cstdint>
+#include<cstdio>
+#include<cstring>
+#include<fstream>
+#include<string>
+#include<utility>
+#include<vector>
+#include<fcntl.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+#include<unistd.h>
+
+/**
+ * @brief
+ *  Layout of a result file, every part of which is aligned to
+ *  8 bytes and stored in the byte order of the machine writing
+ *  it.
+ *
+ * @details
+ *  A result file consists of
+ *  - a `HeaderTy`,
+ *  - `NumStrings + 1` offsets of type `uint32_t` into the string
+ *    data, string `i` starting at offset `i` and ending before
+ *    offset `i + 1` with a terminating null character. The first
+ *    `NumExpressions` strings are the expressions in the order of
+ *    their indexes, and the next `NumPoints` are labels of the
+ *    program points,
+ *  - the string data,
+ *  - a `PointTy` for each program point,
+ *  - the set identifiers, as `int32_t`,
+ *  - the `Parent` map on convergence, as `ParentEntryTy`.
+ *
+ *  The set identifiers at a program point are stored either for
+ *  every expression, or only for the expressions whose set
+ *  identifiers differ from those at an earlier program point,
+ *  usually its predecessor, as pairs of the expression index and
+ *  the set identifier sorted by the expression index. Two
+ *  expressions are equivalent at a program point iff they have
+ *  the same set identifier there.
+ *
+ *  The `Parent` map, `SetCnt` and the counters are saved so that
+ *  the state of the analysis can be restored from a cached file
+ *  without computing the fixpoint.
+ *
+ * @see     ResultFile, writeResultFile
+ **/
+namespace ResultFormat {
+    /**
+     * @brief   Magic bytes at the start of a result file.
+     **/
+    static char const Magic[8] = {'H', 'E', 'R', 'B', 'R', 'E', 'S', '\0'};
+
+    /**
+     * @brief   Version of the format, changed on any change of layout.
+     **/
+    enum { Version = 2 };
+
+    /**
+     * @brief
+     *  `PointTy::Base` of a program point whose set identifiers
+     *  are stored for every expression, and of one holding the TOP
+     *  partition.
+     **/
+    enum { FullPoint = -1, TopPoint = -2 };
+
+    /**
+     * @brief   Header at the start of a result file.
+     **/
+    struct HeaderTy {
+        char Magic[8];
+        uint32_t Version, NumExpressions, NumPoints, NumStrings;
+
+        /**
+         * @brief   Hash of the input analysed, 0 if it is not known.
+         **/
+        uint64_t InputHash;
+
+        /**
+         * @brief   `SetCnt` on convergence, and the number of `Parent` entries.
+         **/
+        uint32_t SetCnt, NumParentEntries;
+
+        /**
+         * @brief   Nodes processed while computing the fixpoint.
+         **/
+        uint64_t Iterations, Transfers, Confluences;
+
+        /**
+         * @brief   File offsets of the parts following the header.
+         **/
+        uint64_t StringOffsets, StringData, Points, SetIds, ParentEntries, FileSize;
+    };
+
+    /**
+     * @brief   Description of the set identifiers at a program point.
+     **/
+    struct PointTy {
+        /**
+         * @brief
+         *  Index of the program point the set identifiers are stored
+         *  relative to, which is smaller than the index of this point,
+         *  or `FullPoint` or `TopPoint`.
+         **/
+        int32_t Base;
+
+        /**
+         * @brief   Number of set identifiers, or of pairs, stored.
+         **/
+        uint32_t Count;
+
+        /**
+         * @brief   Position of the first of them among the set identifiers.
+         **/
+        uint64_t Offset;
+    };
+
+    /**
+     * @brief   An entry of the `Parent` map.
+     **/
+    struct ParentEntryTy {
+        uint64_t Key;
+        int32_t SetId, Unused;
+    };
+
+    /**
+     * @brief
+     *  Longest chain of program points stored relative to one
+     *  another, which bounds the work of a lookup.
+     **/
+    enum { MaxDepth = 16 };
+
+    inline uint64_t align8(uint64_t offset) { return (offset + 7) & ~(uint64_t)7; }
+
+    /**
+     * @brief
+     *  FNV-1a hash of a string, continuing from `seed`, used to
+     *  key the cache by the input analysed.
+     **/
+    inline uint64_t hashString(std::string const &str, uint64_t seed = 0xcbf29ce484222325ULL) {
+        for(unsigned char ch : str) seed = (seed ^ ch) * 0x100000001b3ULL;
+        return seed;
+    }
+
+    /**
+     * @brief   Name of the file caching the result for an input hash.
+     **/
+    inline std::string cacheFileName(std::string const &dir, uint64_t inputHash) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.herb", (unsigned long long)inputHash);
+        return dir + '/' + name;
+    }
+}
+
+/**
+ * @brief   Contents of a result file, as passed to `writeResultFile`.
+ *
+ * @see     ResultFormat, writeResultFile
+ **/
+struct ResultContentsTy {
+    /**
+     * @brief   Text of each expression, in the order of their indexes.
+     **/
+    std::vector<std::string> Expressions;
+
+    /**
+     * @brief   Label, partition and preferred base of each program point.
+     *
+     * @details
+     *  The base of a program point is an earlier program point,
+     *  usually its predecessor, or -1 if there is none.
+     **/
+    std::vector<std::string> Labels;
+    std::vector<Partition> Points;
+    std::vector<int> Bases;
+
+    /**
+     * @brief   Hash of the input analysed, 0 if it is not known.
+     **/
+    uint64_t InputHash = 0;
+
+    /**
+     * @brief   `SetCnt` and the `Parent` entries on convergence.
+     **/
+    int SetCnt = 0;
+    std::vector<std::pair<uint64_t, int>> Parent;
+
+    /**
+     * @brief   Nodes processed while computing the fixpoint.
+     **/
+    uint64_t Iterations = 0, Transfers = 0, Confluences = 0;
+};
+
+/**
+ * @brief
+ *  Writes the partitions at the program points to a result file.
+ *
+ * @details
+ *  The set identifiers at a program point are stored relative to
+ *  its base, when the base is an earlier program point which is
+ *  not TOP and this takes less space than storing all of them.
+ *  Leaves shared by the two partitions are skipped without being
+ *  compared.
+ *
+ *  The file is written under a name of its own and then renamed,
+ *  which replaces any file of the same name at once, so a reader
+ *  never maps a partly written file even if several processes
+ *  write the same file at the same time.
+ *
+ * @param   fname       Name of the file to be written
+ * @param   contents    What is to be written
+ * @returns     True if the file was written otherwise false
+ *
+ * @see     ResultFile, ResultFormat
+ **/
+inline bool writeResultFile(std::string const &fname, ResultContentsTy const &contents) {
+    using namespace ResultFormat;
+    std::vector<Partition> const &partitions = contents.Points;
+    int numExpressions = contents.Expressions.size(), numPoints = partitions.size();
+
+    HeaderTy header;
+    std::memcpy(header.Magic, Magic, sizeof(Magic));
+    header.Version = Version;
+    header.NumExpressions = numExpressions, header.NumPoints = numPoints;
+    header.NumStrings = numExpressions + numPoints;
+    header.InputHash = contents.InputHash;
+    header.SetCnt = contents.SetCnt, header.NumParentEntries = contents.Parent.size();
+    header.Iterations = contents.Iterations, header.Transfers = contents.Transfers;
+    header.Confluences = contents.Confluences;
+
+    std::vector<uint32_t> stringOffsets({0});
+    std::string stringData;
+    for(int i = 0; i < (int)header.NumStrings; i++) {
+        stringData += (i < numExpressions ? contents.Expressions[i] 
+                                          : contents.Labels[i - numExpressions]);
+        stringData += '\0';
+        stringOffsets.push_back(stringData.size());
+    }
+
+    std::vector<PointTy> points(numPoints);
+    std::vector<int32_t> setIds;
+    std::vector<int> depth(numPoints, 0);
+    for(int p = 0; p < numPoints; p++) {
+        Partition const &partition = partitions[p];
+        PointTy &point = points[p];
+        point.Offset = setIds.size();
+
+        if(partition.size() == 0 or partition[0] == -1) {
+            point.Base = TopPoint, point.Count = 0;
+            continue;
+        }
+
+        // entries differing from the base, unless these are too many
+        int base = contents.Bases[p];
+        bool relative = (base >= 0 and base < p and points[base].Base != TopPoint and
+                         depth[base] < MaxDepth);
+        if(relative) {
+            Partition const &basePartition = partitions[base];
+            for(int i = 0; i < numExpressions and relative; i++) {
+                if(i % Partition::LeafSize == 0 and partition.sameLeaf(basePartition, i)) {
+                    i += Partition::LeafSize - 1;
+                    continue;
+                }
+                if(partition[i] == basePartition[i]) continue;
+
+                setIds.push_back(i), setIds.push_back(partition[i]);
+                relative = (setIds.size() - point.Offset < (size_t)numExpressions);
+            }
+        }
+
+        if(relative) {
+            point.Base = base, point.Count = (setIds.size() - point.Offset) / 2;
+            depth[p] = depth[base] + 1;
+        } else {
+            setIds.resize(point.Offset);
+            for(int i = 0; i < numExpressions; i++)
+                setIds.push_back(partition[i]);
+            point.Base = FullPoint, point.Count = numExpressions;
+        }
+    }
+
+    std::vector<ParentEntryTy> parentEntries;
+    for(auto &entry : contents.Parent)
+        parentEntries.push_back({entry.first, entry.second, 0});
+
+    header.StringOffsets = align8(sizeof(HeaderTy));
+    header.StringData = align8(header.StringOffsets + stringOffsets.size() * sizeof(uint32_t));
+    header.Points = align8(header.StringData + stringData.size());
+    header.SetIds = align8(header.Points + points.size() * sizeof(PointTy));
+    header.ParentEntries = align8(header.SetIds + setIds.size() * sizeof(int32_t));
+    header.FileSize = header.ParentEntries + parentEntries.size() * sizeof(ParentEntryTy);
+
+    // a name no other writer uses, in the same directory so that
+    // it can be renamed
+    static std::atomic<unsigned> tempCnt(0);
+    std::string tempName = fname + ".tmp" + std::to_string(getpid()) + '.' +
+                           std::to_string(tempCnt++);
+
+    std::ofstream fout(tempName, std::ios::binary | std::ios::trunc);
+    if(not fout) return false;
+
+    uint64_t written = 0;
+    auto put = [&](uint64_t offset, void const *data, size_t size) {
+        static char const zeros[8] = {};
+        fout.write(zeros, offset - written);
+        fout.write((char const *)data, size);
+        written = offset + size;
+    };
+    put(0, &header, sizeof(header));
+    put(header.StringOffsets, stringOffsets.data(), stringOffsets.size() * sizeof(uint32_t));
+    put(header.StringData, stringData.data(), stringData.size());
+    put(header.Points, points.data(), points.size() * sizeof(PointTy));
+    put(header.SetIds, setIds.data(), setIds.size() * sizeof(int32_t));
+    put(header.ParentEntries, parentEntries.data(), parentEntries.size() * sizeof(ParentEntryTy));
+
+    fout.close();
+    if(not fout or std::rename(tempName.c_str(), fname.c_str()) != 0) {
+        std::remove(tempName.c_str());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief
+ *  Read only view of a result file, mapped into memory so that
+ *  queries read the file directly without parsing it.
+ *
+ * @details
+ *  Finding the set identifier of an expression at a program point
+ *  follows the chain of its bases, which is atmost
+ *  `ResultFormat::MaxDepth` long, doing a binary search at each.
+ *
+ * @see     ResultFormat, writeResultFile
+ **/
+class ResultFile {
+public:
+    ResultFile() : Data(nullptr), Size(0) {}
+    ~ResultFile() { close(); }
+
+    ResultFile(ResultFile const &) = delete;
+    ResultFile &operator=(ResultFile const &) = delete;
+
+    /**
+     * @brief   Method to map a result file, closing any file mapped before.
+     *
+     * @param   fname   Name of the file
+     *
+     * @returns     False if the file could not be mapped or is not a
+     *              valid result file, otherwise true
+     **/
+    bool open(std::string const &fname) {
+        using namespace ResultFormat;
+        close();
+
+        int fd = ::open(fname.c_str(), O_RDONLY);
+        if(fd < 0) return false;
+
+        struct stat st;
+        if(fstat(fd, &st) == 0 and st.st_size >= (off_t)sizeof(HeaderTy)) {
+            void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if(data != MAP_FAILED) Data = (char const *)data, Size = st.st_size;
+        }
+        ::close(fd);
+        if(not Data) return false;
+
+        HeaderTy const &header = this->header();
+        bool valid = std::memcmp(header.Magic, Magic, sizeof(Magic)) == 0 and
+                     header.Version == Version and header.FileSize == Size and
+                     header.NumStrings == header.NumExpressions + header.NumPoints;
+        if(not valid) close();
+        return valid;
+    }
+
+    /**
+     * @brief   Method to unmap the file, if any.
+     **/
+    void close() {
+        if(Data) munmap((void *)Data, Size);
+        Data = nullptr, Size = 0;
+    }
+
+    /**
+     * @brief   Method to return the number of expressions.
+     **/
+    int numExpressions() const { return header().NumExpressions; }
+
+    /**
+     * @brief   Method to return the number of program points.
+     **/
+    int numPoints() const { return header().NumPoints; }
+
+    /**
+     * @brief   Method to return the text of an expression.
+     **/
+    char const *expression(int expIdx) const { return string(expIdx); }
+
+    /**
+     * @brief   Method to return the label of a program point.
+     **/
+    char const *label(int point) const { return string(header().NumExpressions + point); }
+
+    /**
+     * @brief
+     *  Method to find the index of an expression from its text,
+     *  by comparing it with each expression.
+     *
+     * @returns     Index of the expression, -1 if there is none
+     **/
+    int findExpression(std::string const &text) const {
+        for(int i = 0; i < numExpressions(); i++)
+            if(text == expression(i)) return i;
+        return -1;
+    }
+
+    /**
+     * @brief   Method to return whether the partition at a program point is TOP.
+     **/
+    bool isTop(int point) const { return points()[point].Base == ResultFormat::TopPoint; }
+
+    /**
+     * @brief   Method to return the hash of the input analysed, 0 if it is not known.
+     **/
+    uint64_t inputHash() const { return header().InputHash; }
+
+    /**
+     * @brief   Method to return `SetCnt` on convergence.
+     **/
+    int setCnt() const { return header().SetCnt; }
+
+    /**
+     * @brief   Method to return the nodes processed while computing the fixpoint.
+     **/
+    uint64_t iterations() const { return header().Iterations; }
+    uint64_t transfers() const { return header().Transfers; }
+    uint64_t confluences() const { return header().Confluences; }
+
+    /**
+     * @brief   Method to return the set identifier of an expression at a program point.
+     *
+     * @param   point   Index of the program point
+     * @param   expIdx  Index of the expression
+     *
+     * @returns     The set identifier, -1 if the partition is TOP
+     **/
+    int setId(int point, int expIdx) const {
+        using namespace ResultFormat;
+        int32_t const *setIds = (int32_t const *)(Data + header().SetIds);
+
+        while(true) {
+            PointTy const &entry = points()[point];
+            if(entry.Base == TopPoint) return -1;
+            if(entry.Base == FullPoint) return setIds[entry.Offset + expIdx];
+
+            // pairs of expression index and set identifier
+            int lo = 0, hi = entry.Count;
+            while(lo < hi) {
+                int mid = (lo + hi) / 2;
+                if(setIds[entry.Offset + 2 * mid] < expIdx) lo = mid + 1;
+                else hi = mid;
+            }
+            if(lo < (int)entry.Count and setIds[entry.Offset + 2 * lo] == expIdx)
+                return setIds[entry.Offset + 2 * lo + 1];
+            point = entry.Base;
+        }
+    }
+
+    /**
+     * @brief
+     *  Method to return whether two expressions are equivalent at a
+     *  program point. All expressions are equivalent at TOP.
+     **/
+    bool equivalent(int point, int first, int second) const {
+        return setId(point, first) == setId(point, second);
+    }
+
+    /**
+     * @brief
+     *  Method to read the partition at each program point, TOP
+     *  being a partition holding -1 for every expression.
+     *
+     * @details
+     *  A partition stored relative to its base is a copy of the
+     *  partition at the base with the differing entries set, so
+     *  the two share storage as they did when they were written.
+     *
+     * @param[out]  partitions  Partition at each program point
+     * @returns     Void
+     **/
+    void readPartitions(std::vector<Partition> &partitions) const {
+        using namespace ResultFormat;
+        int32_t const *setIds = (int32_t const *)(Data + header().SetIds);
+        int numExpressions = this->numExpressions();
+
+        partitions.assign(numPoints(), Partition());
+        for(int p = 0; p < numPoints(); p++) {
+            PointTy const &entry = points()[p];
+            Partition &partition = partitions[p];
+
+            if(entry.Base == TopPoint) partition.assign(numExpressions, -1);
+            else if(entry.Base == FullPoint) {
+                partition.assign(numExpressions, 0);
+                for(int i = 0; i < numExpressions; i++)
+                    partition.set(i, setIds[entry.Offset + i]);
+            } else {
+                partition = partitions[entry.Base];
+                for(int k = 0; k < (int)entry.Count; k++)
+                    partition.set(setIds[entry.Offset + 2 * k], setIds[entry.Offset + 2 * k + 1]);
+            }
+        }
+    }
+
+    /**
+     * @brief   Method to call `fn(key, setId)` for each saved `Parent` entry.
+     **/
+    template<typename Fn>
+    void forEachParent(Fn fn) const {
+        using namespace ResultFormat;
+        ParentEntryTy const *entries = (ParentEntryTy const *)(Data + header().ParentEntries);
+        for(int i = 0; i < (int)header().NumParentEntries; i++)
+            fn(entries[i].Key, entries[i].SetId);
+    }
+
+private:
+    ResultFormat::HeaderTy const &header() const {
+        return *(ResultFormat::HeaderTy const *)Data;
+    }
+
+    ResultFormat::PointTy const *points() const {
+        return (ResultFormat::PointTy const *)(Data + header().Points);
+    }
+
+    char const *string(int idx) const {
+        uint32_t const *offsets = (uint32_t const *)(Data + header().StringOffsets);
+        return Data + header().StringData + offsets[idx];
+    }
+
+    /**
+     * @brief   Mapped contents of the file, and their size.
+     **/
+    char const *Data;
+    size_t Size;
+};
+
+#endif
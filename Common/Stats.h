@@ -0,0 +1,236 @@
+/**
+ * @file Stats.h
+ *  This file defines the counters and timers of the solver, which
+ *  are compiled in only when `HERBRAND_STATS` is defined to a non
+ *  zero value, and their report in JSON.
+ **/
+
+#ifndef STATS_H
+#define STATS_H
+
+/**
+ * @brief
+ *  Whether the counters and timers are compiled in, off unless
+ *  the build defines it (for example `-DHERBRAND_STATS`).
+ **/
+#ifndef HERBRAND_STATS
+#define HERBRAND_STATS 0
+#endif
+
+#if HERBRAND_STATS
+
+#include<chrono>
+#include<cstdio>
+#include<string>
+#include<utility>
+#include<vector>
+
+// Macro running a statement which updates the counters, removed
+// with them
+#define HERBRAND_STAT(...) do { __VA_ARGS__; } while(0)
+
+// Macro declaring a `PhaseTimer` which adds the time until the end
+// of the enclosing scope to a phase
+#define HERBRAND_TIMER(timer, stats, phase) PhaseTimer timer((stats), (phase))
+
+/**
+ * @brief
+ *  Counters and timers of the analysis of a program.
+ *
+ * @details
+ *  The counters are updated by the solver only from the thread
+ *  computing the fixpoint. Workers solving a wavefront count their
+ *  `findSet` lookups themselves, and these are added to the
+ *  counters once the wavefront is solved. The counts of the nodes
+ *  are kept per node, and two workers never solve the same node.
+ *
+ *  The counts of the nodes and the samples of `SetCnt` are those of
+ *  the last fixpoint computed, like the counters of the solver. The
+ *  other counters and the phases add up over the whole analysis.
+ **/
+struct SolverStatsTy {
+    /**
+     * @brief   Lookups of `Parent` by `findSet` which found the key.
+     **/
+    long long FindSetHits = 0;
+
+    /**
+     * @brief
+     *  Lookups of `Parent` by `findSet` which did not find the key,
+     *  each of which created a set identifier.
+     **/
+    long long FindSetMisses = 0;
+
+    /**
+     * @brief   Calls of `getClass`, and the expressions they scanned.
+     **/
+    long long GetClassCalls = 0, GetClassScanned = 0;
+
+    /**
+     * @brief   Applications of the transfer function at each node.
+     **/
+    std::vector<int> NodeTransfers;
+
+    /**
+     * @brief   Applications of the confluence function at each node.
+     **/
+    std::vector<int> NodeConfluences;
+
+    /**
+     * @brief
+     *  `SetCnt` after some of the iterations, as pairs of the
+     *  iteration and `SetCnt`.
+     *
+     * @details
+     *  A sample is taken once `SampleStride` iterations have passed
+     *  since the last one. When there are `MaxSamples` samples every
+     *  other one is dropped and the stride is doubled, so the samples
+     *  stay about evenly spaced however long the fixpoint takes.
+     *
+     * @see     sampleSetCnt
+     **/
+    std::vector<std::pair<long long, int>> SetCntGrowth;
+    long long SampleStride = 1, NextSample = 0;
+    static constexpr int MaxSamples = 128;
+
+    /**
+     * @brief   Seconds spent in each phase, in the order first timed.
+     **/
+    std::vector<std::pair<std::string, double>> Phases;
+
+    /**
+     * @brief
+     *  Clears the counts of the nodes and the samples of `SetCnt`
+     *  before a fixpoint is computed over `numNodes` nodes.
+     **/
+    void startFixpoint(int numNodes) {
+        NodeTransfers.assign(numNodes, 0);
+        NodeConfluences.assign(numNodes, 0);
+        SetCntGrowth.clear();
+        SampleStride = 1, NextSample = 0;
+    }
+
+    /**
+     * @brief   Records `SetCnt` after an iteration, if it is sampled.
+     *
+     * @see     SetCntGrowth
+     **/
+    void sampleSetCnt(long long iteration, int setCnt) {
+        if(iteration < NextSample) return;
+        if((int)SetCntGrowth.size() == MaxSamples) {
+            for(int i = 0; i < MaxSamples / 2; i++) SetCntGrowth[i] = SetCntGrowth[2 * i + 1];
+            SetCntGrowth.resize(MaxSamples / 2);
+            SampleStride *= 2;
+        }
+        SetCntGrowth.emplace_back(iteration, setCnt);
+        NextSample = iteration + SampleStride;
+    }
+
+    /**
+     * @brief   Adds time to a phase.
+     **/
+    void addPhase(std::string const &phase, double seconds) {
+        for(auto &el : Phases)
+            if(el.first == phase) {
+                el.second += seconds;
+                return;
+            }
+        Phases.emplace_back(phase, seconds);
+    }
+
+    /**
+     * @brief   Returns a string as a JSON string literal.
+     **/
+    static std::string jsonString(std::string const &str) {
+        std::string out = "\"";
+        for(unsigned char ch : str) {
+            if(ch == '"' or ch == '\\') out += '\\', out += ch;
+            else if(ch < 0x20) {
+                char buf[8];
+                snprintf(buf, sizeof(buf), "\\u%04x", ch);
+                out += buf;
+            } else out += ch;
+        }
+        return out + "\"";
+    }
+
+    /**
+     * @brief   Returns the counters and timers as a JSON object.
+     *
+     * @param   name        Name of the program or function analysed
+     * @param   iterations  Nodes processed by the last fixpoint
+     * @param   transfers   Transfer points processed by it
+     * @param   confluences Confluence points processed by it
+     * @param   setCnt      Set identifiers at the end
+     * @returns     The JSON object, on a single line
+     **/
+    std::string toJson(std::string const &name, int iterations, int transfers,
+                       int confluences, int setCnt) const {
+        auto list = [](std::vector<int> const &values) {
+            std::string out = "[";
+            for(size_t i = 0; i < values.size(); i++)
+                out += (i ? "," : "") + std::to_string(values[i]);
+            return out + "]";
+        };
+
+        std::string out = "{\"name\": " + jsonString(name);
+        out += ", \"iterations\": " + std::to_string(iterations);
+        out += ", \"transfers\": " + std::to_string(transfers);
+        out += ", \"confluences\": " + std::to_string(confluences);
+        out += ", \"setCnt\": " + std::to_string(setCnt);
+        out += ", \"findSet\": {\"hits\": " + std::to_string(FindSetHits) +
+               ", \"misses\": " + std::to_string(FindSetMisses) + "}";
+        out += ", \"getClass\": {\"calls\": " + std::to_string(GetClassCalls) +
+               ", \"scanned\": " + std::to_string(GetClassScanned) + "}";
+
+        out += ", \"setCntGrowth\": [";
+        for(size_t i = 0; i < SetCntGrowth.size(); i++)
+            out += (i ? ",[" : "[") + std::to_string(SetCntGrowth[i].first) + "," +
+                   std::to_string(SetCntGrowth[i].second) + "]";
+        out += "]";
+
+        out += ", \"nodeTransfers\": " + list(NodeTransfers);
+        out += ", \"nodeConfluences\": " + list(NodeConfluences);
+
+        out += ", \"phases\": {";
+        for(size_t i = 0; i < Phases.size(); i++) {
+            char seconds[32];
+            snprintf(seconds, sizeof(seconds), "%.9f", Phases[i].second);
+            out += (i ? ", " : "") + jsonString(Phases[i].first) + ": " + seconds;
+        }
+        return out + "}}";
+    }
+};
+
+/**
+ * @brief
+ *  Adds the time from its creation to its destruction to a phase
+ *  of a `SolverStatsTy`.
+ **/
+class PhaseTimer {
+public:
+    PhaseTimer(SolverStatsTy &stats, char const *phase) :
+        Stats(stats), Phase(phase), Start(std::chrono::steady_clock::now()) {}
+
+    ~PhaseTimer() {
+        auto end = std::chrono::steady_clock::now();
+        Stats.addPhase(Phase, std::chrono::duration<double>(end - Start).count());
+    }
+
+    PhaseTimer(PhaseTimer const &) = delete;
+    PhaseTimer &operator=(PhaseTimer const &) = delete;
+
+private:
+    SolverStatsTy &Stats;
+    char const *Phase;
+    std::chrono::steady_clock::time_point Start;
+};
+
+#else
+
+#define HERBRAND_STAT(...) do {} while(0)
+#define HERBRAND_TIMER(timer, stats, phase) do {} while(0)
+
+#endif
+
+#endif
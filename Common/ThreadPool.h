@@ -0,0 +1,204 @@
+/**
+ * @file ThreadPool.h
+ *  This file defines a ThreadPool class, a fixed number of
+ *  threads running the tasks submitted to it with work
+ *  stealing.
+ **/
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include<algorithm>
+#include<atomic>
+#include<condition_variable>
+#include<deque>
+#include<functional>
+#include<memory>
+#include<mutex>
+#include<thread>
+#include<vector>
+
+/**
+ * @brief
+ *  Fixed number of worker threads, each with its own queue of
+ *  tasks, which take tasks from the other queues when their own
+ *  queue is empty.
+ *
+ * @details
+ *  Tasks are dealt to the queues in turn as they are submitted.
+ *  A thread takes the tasks of its own queue in the order they
+ *  were submitted, and steals from the back of the queue of
+ *  another thread, so submitting the largest tasks first starts
+ *  them first and leaves the small ones to balance the load at
+ *  the end.
+ *
+ *  Tasks must not throw, and tasks running at the same time
+ *  must not share any mutable state. The destructor waits for
+ *  all the submitted tasks to finish.
+ **/
+class ThreadPool {
+public:
+    /**
+     * @brief   Constructor for ThreadPool class, starting the threads.
+     *
+     * @param   numThreads  Number of worker threads, atleast one
+     **/
+    ThreadPool(int numThreads) : NextQueue(0), Queued(0), Pending(0), Stopping(false) {
+        numThreads = std::max(numThreads, 1);
+        for(int i = 0; i < numThreads; i++)
+            Queues.emplace_back(new QueueTy());
+        for(int i = 0; i < numThreads; i++)
+            Workers.emplace_back([this, i] { run(i); });
+    }
+
+    /**
+     * @brief   Destructor, waits for the tasks and stops the threads.
+     **/
+    ~ThreadPool() {
+        wait();
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            Stopping = true;
+        }
+        TaskReady.notify_all();
+        for(auto &worker : Workers) worker.join();
+    }
+
+    ThreadPool(ThreadPool const &) = delete;
+    ThreadPool &operator=(ThreadPool const &) = delete;
+
+    /**
+     * @brief   Method to add a task to the next queue in turn.
+     *
+     * @param   task    The task to be run by one of the threads
+     *
+     * @returns     None
+     **/
+    void submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            QueueTy &queue = *Queues[NextQueue];
+            NextQueue = (NextQueue + 1) % Queues.size();
+
+            std::lock_guard<std::mutex> queueLock(queue.Mutex);
+            queue.Tasks.push_back(std::move(task));
+            Queued++, Pending++;
+        }
+        TaskReady.notify_one();
+    }
+
+    /**
+     * @brief   Method to wait until all the submitted tasks have finished.
+     *
+     * @returns     None
+     **/
+    void wait() {
+        std::unique_lock<std::mutex> lock(Mutex);
+        AllDone.wait(lock, [this] { return Pending == 0; });
+    }
+
+    /**
+     * @brief   Method to return the number of worker threads.
+     **/
+    int size() const { return Workers.size(); }
+
+private:
+    /**
+     * @brief   Queue of tasks of a worker thread.
+     **/
+    struct QueueTy {
+        std::mutex Mutex;
+        std::deque<std::function<void()>> Tasks;
+    };
+
+    /**
+     * @brief
+     *  Method to take a task, from the front of the queue of the
+     *  worker thread `self` or else from the back of another queue.
+     *
+     * @param   self    Index of the worker thread
+     * @param   task    The task taken
+     *
+     * @returns     True if a task was taken otherwise false
+     **/
+    bool take(int self, std::function<void()> &task) {
+        int numQueues = Queues.size();
+        for(int k = 0; k < numQueues; k++) {
+            QueueTy &queue = *Queues[(self + k) % numQueues];
+            {
+                std::lock_guard<std::mutex> queueLock(queue.Mutex);
+                if(queue.Tasks.empty()) continue;
+
+                if(k == 0) task = std::move(queue.Tasks.front()), queue.Tasks.pop_front();
+                else task = std::move(queue.Tasks.back()), queue.Tasks.pop_back();
+
+                // uncounted while the queue is still locked, so a thread
+                // finding all the queues empty never counts this task
+                Queued--;
+            }
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief   Loop run by each worker thread.
+     *
+     * @param   self    Index of the worker thread
+     **/
+    void run(int self) {
+        while(true) {
+            std::function<void()> task;
+            if(not take(self, task)) {
+                // a task counted in `Queued` was submitted after its
+                // queue was looked at, in which case this is tried again
+                std::unique_lock<std::mutex> lock(Mutex);
+                TaskReady.wait(lock, [this] { return Stopping or Queued > 0; });
+                if(Queued == 0) return;
+                continue;
+            }
+
+            task();
+
+            std::lock_guard<std::mutex> lock(Mutex);
+            if(--Pending == 0) AllDone.notify_all();
+        }
+    }
+
+    /**
+     * @brief   Queue of each worker thread.
+     **/
+    std::vector<std::unique_ptr<QueueTy>> Queues;
+
+    /**
+     * @brief   The worker threads.
+     **/
+    std::vector<std::thread> Workers;
+
+    /**
+     * @brief   Queue to which the next task is submitted.
+     **/
+    int NextQueue;
+
+    /**
+     * @brief
+     *  Number of tasks waiting in the queues, changed with the lock
+     *  of the queue held.
+     **/
+    std::atomic<int> Queued;
+
+    /**
+     * @brief   Number of tasks submitted but not yet finished.
+     **/
+    int Pending;
+
+    /**
+     * @brief   Whether the threads should exit once the queues are empty.
+     **/
+    bool Stopping;
+
+    std::mutex Mutex;
+    std::condition_variable TaskReady, AllDone;
+};
+
+#endif
@@ -10,8 +10,20 @@
 #include "llvm/ADT/SetVector.h"
 #include "llvm/IR/DebugInfo.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/IR/DebugInfoMetadata.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IR/ModuleSlotTracker.h"
+#include "llvm/IR/PassManager.h"
+#include "llvm/Passes/PassBuilder.h"
+#include "llvm/Passes/PassPlugin.h"
 #include <bits/stdc++.h>
+#include "FlatHashMap.h"
+#include "InternMapVector.h"
+#include "Partition.h"
+#include "ResultFile.h"
+#include "Stats.h"
+#include "ThreadPool.h"
 
 using namespace llvm;
 
@@ -27,26 +39,24 @@ using namespace llvm;
 #define EXP(x) {'\0', (x), nullptr}
 
 /**
- * @brief 
- *  Generic function to find the intersection 
- *  of two std::set.
+ * @brief Hash function for a tuple of set identifiers.
  * 
- * @tparam          T     Any valid type for which std::set 
- *                        can be created
- * @param[in]       xset  Reference to first input set
- * @param[in, out]  yset  Reference to second input set
- * @return          Void
+ * @details
+ *  Used to key `std::unordered_map` with the set identifiers 
+ *  of an expression across the predecessors of a confluence 
+ *  point.
  * 
- * @note The first input argument is modified to contain the intersection.
+ * @see     HerbrandPass::confluenceClosure, HerbrandPass::confluenceFunction
  **/
-template <typename T>
-void setIntersect(std::set<T> &xset, std::set<T> &yset) {
-    for(auto it = xset.begin(); it != xset.end(); ) {
-        auto it_ = it++;
-        if(yset.find(*it_) == yset.end())
-            xset.erase(it_);
+struct SetIdTupleHash {
+    template<typename T>
+    size_t operator()(std::vector<T> const &tup) const {
+        size_t seed = tup.size();
+        for(T el : tup)
+            seed ^= std::hash<T>()(el) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        return seed;
     }
-}
+};
 
 /**
  * @brief 
@@ -73,27 +83,197 @@ char getOpSymbol(std::string opCodeName) {
  **/
 namespace HerbrandPass {
 
-    /** 
-     * @brief Set of constants used in the program.
+    /**
+     * @brief
+     *  Whether only the constants, variables and the length two
+     *  expressions appearing in the function are tracked.
      *
-     * @note 
-     *  Value is LLVM structure used for representing
-     *  constants and variables.
-     * 
-     * @see     llvm::Value
+     * @details
+     *  In this mode partitions hold set identifiers only for the
+     *  expressions indexed by `Indexer`, which are linear in the
+     *  size of the function. The set identifier of any other 
+     *  length two expression `l op r` at a program point is 
+     *  implicitly the one mapped by `Parent` to `op` and the set
+     *  identifiers of `l` and `r` there, and a fresh one if there
+     *  is none. `confluenceClosure` keeps `Parent` consistent with
+     *  this at confluence points.
+     *
+     * @see     ClosureSignature, confluenceClosure, Indexer
      **/
-    std::set<Value *> Constants;
-    
-    /** 
-     * @brief Set of variables used in the program.
+    cl::opt<bool> SparseMode("herbrand-sparse", cl::init(false),
+        cl::desc("Track only the expressions appearing in the function"));
+
+    /**
+     * @brief
+     *  Number of threads analysing the functions of a module at
+     *  the same time, all the cores if it is 0.
      *
-     * @note 
-     *  Value is LLVM structure used for representing
-     *  constants and variables.
-     * 
-     * @see     llvm::Value
+     * @see     analyseModule
+     **/
+    cl::opt<unsigned> NumThreads("herbrand-threads", cl::init(0),
+        cl::desc("Number of threads analysing the functions of a module"));
+
+    /**
+     * @brief
+     *  Whether the fixpoint of a function is computed by wavefronts
+     *  of the strongly connected components of its basic block
+     *  graph, solving the components of a wavefront at the same time
+     *  on `NumThreads` threads.
+     *
+     * @see     AnalysisContext::solveWavefront
+     **/
+    cl::opt<bool> WavefrontMode("herbrand-wavefront", cl::init(false),
+        cl::desc("Solve independent parts of a function at the same time"));
+
+    /**
+     * @brief
+     *  Smallest number of set identifiers at which the set 
+     *  identifiers of a function are compacted, 0 to never compact
+     *  them.
+     *
+     * @see     AnalysisContext::maybeCompact
+     **/
+    cl::opt<unsigned> CompactThreshold("herbrand-compact-threshold", cl::init(1 << 16),
+        cl::desc("Number of set identifiers at which unused ones are dropped"));
+
+    /**
+     * @brief
+     *  Amount of output printed by the legacy pass. The code and the
+     *  graphs are printed above `FINAL`.
+     **/
+    enum VerbosityTy {
+        /** Only the partitions once the fixpoint is computed */
+        FINAL,
+        /** Also a line for each basic block processed */
+        SUMMARY,
+        /** Also the partition at each basic block processed */
+        TRACE
+    };
+
+    /**
+     * @brief
+     *  Amount of output printed by the legacy pass, the full trace
+     *  by default. Below `TRACE` the partitions at the basic blocks
+     *  processed are not even looked at.
+     *
+     * @see     AnalysisContext::HerbrandAnalysis
+     **/
+    cl::opt<VerbosityTy> Verbosity("herbrand-verbosity", cl::init(TRACE),
+        cl::desc("Amount of output printed by -HerbrandPass"),
+        cl::values(clEnumValN(FINAL, "final", "Only the partitions after convergence"),
+                   clEnumValN(SUMMARY, "summary", "Also a line for each basic block processed"),
+                   clEnumValN(TRACE, "trace", "Also the partition at each basic block processed")));
+
+    /**
+     * @brief
+     *  Directory to which the partitions of each function analysed 
+     *  are saved as a result file `<function name>.herb`, nothing is
+     *  saved if it is empty.
+     *
+     * @see     AnalysisContext::writeResult, ResultFile
+     **/
+    cl::opt<std::string> BinaryDir("herbrand-binary-dir", cl::init(""),
+        cl::desc("Directory to save the partitions of each function to"),
+        cl::value_desc("directory"));
+
+    /**
+     * @brief
+     *  Directory of the cache of results, nothing is cached if it
+     *  is empty.
+     *
+     * @details
+     *  The result for a function is saved as a result file named by
+     *  the hash of the function, and is read back instead of 
+     *  computing the fixpoint when the same function is analysed
+     *  with the same options.
+     *
+     * @see     AnalysisContext::inputHash, AnalysisContext::readResult
+     **/
+    cl::opt<std::string> CacheDir("herbrand-cache-dir", cl::init(""),
+        cl::desc("Directory of the cache of results"),
+        cl::value_desc("directory"));
+
+    /**
+     * @brief
+     *  Makes `errs()`, which writes its output as soon as it gets
+     *  it, keep its output in a buffer while an object of this 
+     *  class is alive, so that it is written in large blocks.
+     **/
+    struct BufferedErrs {
+        BufferedErrs() { errs().SetBufferSize(1 << 20); }
+        ~BufferedErrs() { errs().SetUnbuffered(); }
+    };
+
+#if HERBRAND_STATS
+    /**
+     * @brief
+     *  File to which the counters and timers of the functions 
+     *  analysed are written at exit, standard error if it is empty.
+     *  Only in builds with `HERBRAND_STATS`.
+     *
+     * @see     StatsReport
      **/
-    std::set<Value *> Variables;
+    cl::opt<std::string> StatsFile("herbrand-stats-file", cl::init(""),
+        cl::desc("File to write the counters and timers of the analysis to"),
+        cl::value_desc("file"));
+
+    /**
+     * @brief
+     *  Counters and timers of the functions analysed, as JSON objects,
+     *  written as a JSON array when the process exits.
+     *
+     * @details
+     *  Functions may be analysed on several threads, so adding an
+     *  object is synchronised. The report is written with `std::cerr`
+     *  or `std::ofstream`, which unlike `errs()` are still there when
+     *  static objects are destroyed.
+     *
+     * @see     AnalysisContext::reportStats, StatsFile
+     **/
+    class StatsReport {
+    public:
+        /**
+         * @brief   Returns the report, created when first used.
+         **/
+        static StatsReport &get() {
+            static StatsReport report;
+            return report;
+        }
+
+        /**
+         * @brief   Adds the JSON object of a function to the report.
+         **/
+        void add(std::string json) {
+            std::lock_guard<std::mutex> lock(Lock);
+            Functions.push_back(std::move(json));
+        }
+
+        ~StatsReport() {
+            std::ofstream fout;
+            if(not StatsFile.empty()) fout.open(StatsFile);
+            std::ostream &os = (StatsFile.empty() ? std::cerr : fout);
+
+            os << "[\n";
+            for(int i = 0; i < (int)Functions.size(); i++)
+                os << "  " << Functions[i] << (i + 1 < (int)Functions.size() ? ",\n" : "\n");
+            os << "]\n";
+            if(not os) std::cerr << "Could not write " << StatsFile << "\n";
+        }
+
+    private:
+        StatsReport() = default;
+
+        std::mutex Lock;
+        std::vector<std::string> Functions;
+    };
+#endif
+
+    /**
+     * @brief   Number of threads given by `NumThreads`.
+     **/
+    int threadCount() {
+        return NumThreads ? NumThreads : std::max(1u, std::thread::hardware_concurrency());
+    }
 
     /**
      * @brief Set of operators used in the program.
@@ -126,75 +306,239 @@ namespace HerbrandPass {
 
     /**
      * @brief
-     *  Maps expressions to integer indexes. This indexing is
-     *  arbitrarily fixed in the beginning and used throughout 
-     *  wherever indexing is required for the expressions.
-     * 
-     * @see     ExpressionTy, Partitions
-     **/
-    std::map<ExpressionTy, int> IndexExp;
-
-    /**
-     * @brief
-     *  Counter to keep track of set identifiers. New set 
-     *  identifiers are created by incrementing this counter.
-     * 
-     * @see     ExpressionTy, Partitions
-     **/
-    int SetCnt = 0;
-
-    /**
-     * @brief
-     *  Vector to keep track of equivalence classes at each
-     *  program point.
-     * 
+     *  Maps expressions of length atmost two to integer indexes
+     *  and back without storing the expressions.
+     *
      * @details
-     *  There is an entry for each program point in this vector
-     *  which itself is a vector containing an entry for each 
-     *  expression of length atmost two. The entries for the 
-     *  expressions contains integer set identifiers. For a
-     *  given program point two expressions are equivalent iff
-     *  they have the same set identifier.
+     *  Constants and variables are numbered `0` to `N - 1` in
+     *  the order they are passed to `init`, these are the *value
+     *  indexes*. The expression `l op r`, where `op` is the `k`th
+     *  operator and `l`, `r` are the value indexes of the operands,
+     *  gets the index `N + k * N * N + l * N + r`. Only the value
+     *  indexes are stored (in an `InternMapVector`), everything else
+     *  is computed.
      *
-     * @note
-     *  For a normal program point the entries for expressions
-     *  in the `Partitions` vector are non-negative. But, if the 
-     *  partition represents TOP partition, the entries for all
-     *  the expressions are -1. And the entry for any expression
-     *  being -1 is sufficient to conclude that the partition
-     *  vector represents TOP partition.
-     * 
-     * @see     IndexExp, SetCnt
+     *  In sparse mode (see `initSparse`) only the length two
+     *  expressions passed are indexed, as `N`, `N + 1`, ... in
+     *  the order given, and `index` returns -1 for the rest.
+     *
+     * @see     ExpressionTy
      **/
-    std::vector<std::vector<int>> Partitions;
+    class ExpressionIndexer {
+    public:
+        /**
+         * @brief   Constructor for ExpressionIndexer class.
+         **/
+        ExpressionIndexer() : NumValues(0), Sparse(false) { clear(); }
 
-    /**
-     * @brief
-     *  Map to hold parent set identifiers.
-     * 
-     * @details
-     *  a1 =~ a2 and b1 =~ b2 at a program point iff
-     *  (a1 + b1) =~ (a2 + b2). Parent map helps us 
-     *  to resolve this by storing set identifiers of 
-     *  compound expression (a1 + b1) as parent of set 
-     *  identifiers of its smaller sub-expressions (a1 
-     *  and b1). Now, later when a new expression is 
-     *  formed by combining expressions (a2 and b2) with 
-     *  same set identifiers as those of the two 
-     *  sub-expressions (a1 and b1), we assign it 
-     *  (a2 + b2) the same identifier as the previous 
-     *  compound expression (a1 + b1).
-     *  This map also helps to resolve other complex 
-     *  cases where some equivalence classes are lost in 
-     *  the middle of the program but appears later.
-     *  
-     * @note
-     *  The two integers in the key of this map are ordered.
-     *  Also this map is global used throughout the program.
-     * 
-     * @see     IndexExp, Partitions, SetCnt
-     **/
-    std::map<std::tuple<char, int, int>, int> Parent;
+        /**
+         * @brief Initialises the object for a function.
+         *
+         * @param   values  Constants and variables of the function
+         * @param   ops     Operators used in the function
+         *
+         * @returns     None
+         **/
+        void init(std::vector<Value *> const &values, std::set<char> const &ops) {
+            clear();
+            for(Value *value : values) Values.insert(value);
+            NumValues = Values.size();
+            for(char op : ops) {
+                OpIndex[(unsigned char)op] = OpList.size();
+                OpList.push_back(op);
+            }
+        }
+
+        /**
+         * @brief
+         *  Initialises the object for a function in sparse mode,
+         *  where only the given length two expressions are indexed.
+         *
+         * @param   values  Constants and variables of the function
+         * @param   ops     Operators used in the function
+         * @param   exps    Length two expressions to be indexed, their
+         *                  operators and operands must be indexed and
+         *                  duplicates are indexed once
+         *
+         * @returns     None
+         **/
+        void initSparse(std::vector<Value *> const &values, std::set<char> const &ops,
+                        std::vector<ExpressionTy> const &exps) {
+            init(values, ops);
+            Sparse = true;
+
+            for(auto &exp : exps) {
+                char op = std::get<0>(exp);
+                int left = valueIndex(std::get<1>(exp));
+                int right = valueIndex(std::get<2>(exp));
+                assert(OpIndex[(unsigned char)op] != -1 and left != -1 and right != -1);
+
+                int idx = NumValues + (int)TrackedOp.size();
+                if(not TrackedIndex.insert(packKey(op, left, right), idx).second) continue;
+
+                TrackedOp.push_back(op);
+                TrackedLeft.push_back(left), TrackedRight.push_back(right);
+            }
+        }
+
+        /**
+         * @brief Method to clear the object.
+         *
+         * @returns     None
+         **/
+        void clear() {
+            Values.clear(), OpList.clear();
+            NumValues = 0, Sparse = false;
+            std::fill(OpIndex, OpIndex + 256, -1);
+            TrackedOp.clear(), TrackedLeft.clear(), TrackedRight.clear();
+            TrackedIndex.clear();
+        }
+
+        /**
+         * @brief Method to return whether the object is in sparse mode.
+         **/
+        bool isSparse() const { return Sparse; }
+
+        /**
+         * @brief Method to return the operators, in indexing order.
+         **/
+        std::vector<char> const &ops() const { return OpList; }
+
+        /**
+         * @brief Method to return the number of expressions indexed.
+         **/
+        int size() const {
+            if(Sparse) return NumValues + (int)TrackedOp.size();
+            return NumValues + (int)OpList.size() * NumValues * NumValues;
+        }
+
+        /**
+         * @brief Method to return the number of constants and variables.
+         **/
+        int numValues() const { return NumValues; }
+
+        /**
+         * @brief Method to return whether an index is a value index.
+         **/
+        bool isValue(int idx) const { return idx < NumValues; }
+
+        /**
+         * @brief Method returning index for a constant or a variable.
+         *
+         * @param   value   The constant or variable
+         *
+         * @returns     The value index of the argument, -1 if it is
+         *              not tracked (eg. a function argument)
+         **/
+        int valueIndex(Value *value) const { return Values.getInt(value); }
+
+        /**
+         * @brief Method used for forward mapping.
+         *
+         * @param   exp     Expression to be mapped
+         *
+         * @returns     The index corresponding to the expression, -1
+         *              if its operator or any of its operands is not
+         *              tracked or, in sparse mode, if it is not indexed
+         **/
+        int index(ExpressionTy const &exp) const {
+            char op = std::get<0>(exp);
+            if(op == '\0') return valueIndex(std::get<1>(exp));
+
+            int k = OpIndex[(unsigned char)op];
+            int left = valueIndex(std::get<1>(exp));
+            int right = valueIndex(std::get<2>(exp));
+            if(k == -1 or left == -1 or right == -1) return -1;
+
+            if(Sparse) return TrackedIndex.find(packKey(op, left, right));
+            return NumValues + (k * NumValues + left) * NumValues + right;
+        }
+
+        /**
+         * @brief Method returning the operator of a length two expression.
+         **/
+        char op(int idx) const {
+            if(Sparse) return TrackedOp[idx - NumValues];
+            return OpList[(idx - NumValues) / (NumValues * NumValues)];
+        }
+
+        /**
+         * @brief
+         *  Method returning value index of the left operand of a
+         *  length two expression.
+         **/
+        int leftIndex(int idx) const {
+            if(Sparse) return TrackedLeft[idx - NumValues];
+            return (idx - NumValues) / NumValues % NumValues;
+        }
+
+        /**
+         * @brief
+         *  Method returning value index of the right operand of a
+         *  length two expression.
+         **/
+        int rightIndex(int idx) const {
+            if(Sparse) return TrackedRight[idx - NumValues];
+            return (idx - NumValues) % NumValues;
+        }
+
+        /**
+         * @brief Method used for reverse mapping.
+         *
+         * @param   idx     Index of an expression
+         *
+         * @returns     The expression corresponding to the index
+         **/
+        ExpressionTy expression(int idx) const {
+            assert(idx >= 0 && idx < size() && "Expression index out of range");
+            if(isValue(idx)) return EXP(Values[idx]);
+            return ExpressionTy(op(idx), Values[leftIndex(idx)], Values[rightIndex(idx)]);
+        }
+
+    private:
+        /**
+         * @brief
+         *  Constants and variables, mapped to their value indexes
+         *  and back.
+         **/
+        InternMapVector<Value *> Values;
+
+        /**
+         * @brief   Number of constants and variables.
+         **/
+        int NumValues;
+
+        /**
+         * @brief   Operators, in the order used for indexing.
+         **/
+        std::vector<char> OpList;
+
+        /**
+         * @brief   Position of each operator in `OpList`, -1 if absent.
+         **/
+        int OpIndex[256];
+
+        /**
+         * @brief   Whether only the expressions in `Tracked*` are indexed.
+         **/
+        bool Sparse;
+
+        /**
+         * @brief
+         *  Operator and value indexes of the operands of each length
+         *  two expression indexed in sparse mode.
+         **/
+        std::vector<char> TrackedOp;
+        std::vector<int> TrackedLeft, TrackedRight;
+
+        /**
+         * @brief
+         *  Index of each length two expression indexed in sparse
+         *  mode, keyed by `packKey` of its operator and operand
+         *  value indexes.
+         **/
+        FlatHashMap TrackedIndex;
+    };
 
     /**
      * @struct 
@@ -237,27 +581,52 @@ namespace HerbrandPass {
          *  is non-empty.
          **/
         std::vector<int> predecessors;
+
+        /**
+         * @brief
+         *  Vector of indexes of successor control flow
+         *  graph nodes corresponding to `CFG` vector.
+         **/
+        std::vector<int> successors;
     };
 
     /**
-     * @brief
-     *  Control flow graph corresponding to the program.
-     * 
-     * @details
-     *  It contains nodes only corresponding to reachable
-     *  instructions and confluence points along with two
-     *  special START and END nodes.
-     * 
-     * @see     CfgNodeTy, createCFG
+     * @struct
+     *  Represents a node of the basic block graph, over which
+     *  the fixpoint is computed. There is a node for each
+     *  reachable basic block, alongwith two special - START and
+     *  END nodes.
+     *
+     * @see     Blocks, createCFG, llvm::BasicBlock
      **/
-    std::vector<CfgNodeTy> CFG;
+    struct BlockNodeTy {
+        /**
+         * @brief Type of basic block graph node.
+         **/
+        enum {START, END, BLOCK} NodeTy;
 
-    /**
-     * @brief Stores `CFG` index for each instruction.
-     * 
-     * @see     CFG, CfgNodeTy
-     **/
-    std::map<Instruction *, int> CfgIndex;
+        /**
+         * @brief
+         *  Pointer to the basic block corresponding to the node
+         *  if it is a BLOCK node, otherwise holds `nullptr`.
+         **/
+        BasicBlock *bbPtr;
+
+        /**
+         * @brief
+         *  `CFG` index of the first node for the block, which is
+         *  its confluence point if it has one. For START and END
+         *  nodes it is the index of the corresponding CFG node.
+         **/
+        int cfgIndex;
+
+        /**
+         * @brief
+         *  Vectors of indexes of predecessor and successor nodes
+         *  corresponding to `Blocks` vector.
+         **/
+        std::vector<int> predecessors, successors;
+    };
 
     /**
      * @brief 
@@ -287,245 +656,42 @@ namespace HerbrandPass {
     }
 
     /**
-     * @brief 
-     *  Maps expressions of length atmost two to integers
-     *  arbitrarily for indexing purpose by updating 
-     *  `IndexExp` map. Also Initialises `Constants` and
-     *  `Variables` by looking through the instructions in 
-     *  the program.
+     * @brief Prints a constant/variable in readable form.
      * 
-     * @param[in]   F     Function block over which 
-     *                    we are operating
+     * @param[in]   value   LLVM representation of constant/variable
+     * @param[in]   os      Stream to print to, the error stream by default
      * @returns     Void
      * 
-     * @see     Constants, IndexExp, Variables
+     * @see     llvm::Value
      **/
-    void assignIndex(Function &F) {
-        ////////////////////////////////////////////////////
-        // First update `Constants` and `Variables` sets by
-        // iterating over instructions in the program
-        ////////////////////////////////////////////////////
-        
-        for(Instruction &I : instructions(&F)) {
-            // if the instruction is not of void type then 
-            // it represents a variable. All the variables
-            // will be covered in this case
-            if(not I.getType()->isVoidTy()) 
-                Variables.insert(&I);
-
-            // now we iterate over its operands to find the 
-            // constants, this case won't add any extra variables
-            // Also, we should skip alloca instruction as its
-            // operands doesn't contain any constant that
-            // concerns us
-            if(isa<AllocaInst>(&I)) continue;
-            for(int i = 0; i < (int)I.getNumOperands(); i++) {
-                Value *value = I.getOperand(i);
-                if(dyn_cast<ConstantInt>(value)) {
-                    Constants.insert(value);
-                }
-            }
-        }
-
-        ////////////////////////////////////////////////////
-        // Now assign indexes to expressions of length 
-        // atmost two by updating `IndexExp` map
-        ////////////////////////////////////////////////////
-
-        // set to hold both constants and variables
-        std::set<Value *> CuV = Constants;
-        CuV.insert(Variables.begin(), Variables.end());
-
-        int ctr = 0;
-        for(auto el : CuV) IndexExp[EXP(el)] = ctr++;
-        for(auto op : Ops)
-            for(auto left : CuV)
-                for(auto right : CuV)
-                    IndexExp[{op, left, right}] = ctr++;
+    void printValue(Value const *value, raw_ostream &os = errs()) {
+        // if the argument is a constant print its value
+        // else it is a variable - print its assigned name
+        if(dyn_cast<ConstantInt>(value))
+            os << dyn_cast<ConstantInt>(value)->getValue().toString(10, true);
+        else os << value->getName();
     }
 
     /**
-     * @brief
-     *  Creates control flow graph corresponding to
-     *  the program.
+     * @brief Prints an expression in readable form.
+     * 
+     * @param[in]   exp  Expression to be printed
+     * @param[in]   os   Stream to print to, the error stream by default
+     * @returns     Void
      * 
-     * @see     CfgNodeTy, CFG
+     * @see     ExpressionTy
      **/
-    void createCFG(Function &F) {
-        ////////////////////////////////////////////////////
-        // First find the set of reachable basic blocks by
-        // performing BFS from the starting basic block
-        ////////////////////////////////////////////////////
-        
-        std::set<BasicBlock *> reachableBB;
-        std::queue<BasicBlock *> q;
-
-        // the list of basic blocks in the same order as
-        // visited by BFS, for same traversal later again
-        std::vector<BasicBlock *> bfsOrder;
-
-        // mark the starting basic block as reachable
-        // and also push it into the queue for BFS
-        q.push(&F.front()), reachableBB.insert(&F.front());
-
-        while(not q.empty()) {
-            BasicBlock *bb = q.front();
-            q.pop(), bfsOrder.push_back(bb);
-
-            for(BasicBlock *nbb : successors(bb)) {
-                if(reachableBB.find(nbb) == reachableBB.end())
-                    reachableBB.insert(nbb), q.push(nbb);
-            }
+    void printExpression(ExpressionTy const &exp, raw_ostream &os = errs()) {
+        if(std::get<0>(exp)) {
+            // if `exp` is a two length expression
+            printValue(std::get<1>(exp), os);
+            os << " " << std::get<0>(exp) << " ";
+            printValue(std::get<2>(exp), os);
+        } else {
+            // if `exp` is just a constant/variable
+            printValue(std::get<1>(exp), os);
         }
-
-        ////////////////////////////////////////////////////
-        // Now again visit the basic blocks in the same 
-        // order assigning an index for nodes in the control
-        // flow graph vector `CFG` corresponding to
-        // instructions and confluence points
-        ////////////////////////////////////////////////////
-
-        // some basic blocks might have just one
-        // predecessor, in that case they don't require
-        // a confluence node in the control flow graph.
-        // This set keeps track of all the basic blocks
-        // that require a confluence node
-        std::set<BasicBlock *> confBlocks;
-
-        // keeps track of current `CFG` index. Index 0 is
-        // assigned to the starting node
-        int curCfgIndex = 1;
-
-        for(BasicBlock *bb : bfsOrder) {
-            // number of predecessor basic blocks of `bb`,
-            // which are reachable
-            int predSz = 0;
-            for(BasicBlock *nbb : predecessors(bb)) {
-                if(reachableBB.find(nbb) != reachableBB.end())
-                    predSz++;
-            }
-
-            // if this basic block requires a confluence node,
-            // first assign an index to it
-            if(predSz > 1)
-                confBlocks.insert(bb), curCfgIndex++;
-            
-            // now assign nodes for the instructions in the
-            // basic block
-            for(Instruction &I : (*bb))
-                CfgIndex[&I] = curCfgIndex++;
-        }
-
-        ////////////////////////////////////////////////////
-        // Now actually create control flow graph nodes by
-        // filling `CFG` vector. Note that the consistency
-        // between `CfgIndex` and actual index of node for
-        // instructions in `CFG` vector is implicitly 
-        // maintained
-        ////////////////////////////////////////////////////
-
-        // START node
-        CFG.push_back({CfgNodeTy::START, nullptr, std::vector<int>()});
-
-        // `CFG` nodes that are predecessors of the special END
-        // END instruction. Last instruction of the basic blocks 
-        // that have no successors belong to this category. Only
-        // if this vector is non-empty, an END node is created
-        std::vector<int> predsEnd;
-
-        for(auto bb : bfsOrder) {
-            // holds index of predecessor nodes for instructions
-            // in this block
-            int predIndex;
-
-            // if the block requires a confluence point,
-            // first push it into the `CFG` vector
-            if(confBlocks.find(bb) != confBlocks.end()) {
-                std::vector<int> preds;
-                for(BasicBlock *nbb : predecessors(bb)) {
-                    if(reachableBB.find(nbb) != reachableBB.end())
-                        preds.push_back(CfgIndex[&nbb->back()]);
-                }
-                CFG.push_back({CfgNodeTy::CONFLUENCE, nullptr, preds});
-
-                // initialise `predIndex`
-                predIndex = CFG.size() - 1;
-            } else {
-                // here only `predIndex` is 
-                
-                // this initialisation is for the first basic block
-                // for which the `if` condition inside `for` never
-                // becomes true
-                predIndex = 0;
-
-                for(BasicBlock *nbb : predecessors(bb))
-                    if(reachableBB.find(nbb) != reachableBB.end()) {
-                        // if `break` is removed, even then the `if` 
-                        // block should be entered only once (except
-                        // for the first basic block for which it is 
-                        // entered never)
-                        predIndex = CfgIndex[&nbb->back()];
-                        break;
-                    }
-            }
-
-            // now insert nodes corresponding to the instructions
-            for(Instruction &I : (*bb)) {
-                CFG.push_back({CfgNodeTy::TRANSFER, &I, 
-                               std::vector<int>({predIndex})});
-
-                // update `predIndex`
-                predIndex = CFG.size() - 1;
-
-                // this assertion must be passed for consistency
-                // of this function
-                assert(predIndex == CfgIndex[&I]);
-            }
-
-            if(succ_empty(bb)) predsEnd.push_back(CfgIndex[&bb->back()]);
-        }
-
-        // now create node corresponding to END, if required
-        if(not predsEnd.empty()) {
-            CFG.push_back({CfgNodeTy::END, nullptr, predsEnd});
-        }
-    }
-    
-    /**
-     * @brief Prints a constant/variable in readable form.
-     * 
-     * @param[in]   value   LLVM representation of constant/variable
-     * @returns     Void
-     * 
-     * @see     llvm::Value
-     **/
-    void printValue(Value const *value) {
-        // if the argument is a constant print its value
-        // else it is a variable - print its assigned name
-        if(dyn_cast<ConstantInt>(value))
-            errs() << dyn_cast<ConstantInt>(value)->getValue().toString(10, true);
-        else errs() << value->getName();
-    }
-
-    /**
-     * @brief Prints an expression in readable form.
-     * 
-     * @param[in]   exp  Expression to be printed
-     * @returns     Void
-     * 
-     * @see     ExpressionTy
-     **/
-    void printExpression(ExpressionTy const &exp) {
-        if(std::get<0>(exp)) {
-            // if `exp` is a two length expression
-            printValue(std::get<1>(exp));
-            errs() << " " << std::get<0>(exp) << " ";
-            printValue(std::get<2>(exp));
-        } else {
-            // if `exp` is just a constant/variable
-            printValue(std::get<1>(exp));
-        }
-    }
+    }
 
     /**
      * @brief Prints the llvm source code.
@@ -553,66 +719,18 @@ namespace HerbrandPass {
         errs() << "\n\n";
     }
 
-    /**
-     * @brief 
-     *  Prints the control flow graph corresponding to 
-     *  the program
-     * 
-     * @returns     Void
-     * 
-     * @see     CFG, CfgNodeTy
-     **/
-    void printCFG() {
-        PRINT_HEADER("CONTROL FLOW GRAPH");
-        errs() << "\n";
-
-        for(int i = 0; i < (int)CFG.size(); i++) {
-            CfgNodeTy &node = CFG[i];
-            errs() << '[' << i << "] : ";
-
-            switch(node.NodeTy) {
-                case CfgNodeTy::START :
-                    errs() << "START\n";
-                    break;
-
-                case CfgNodeTy::END :
-                    errs() << "END  [Predecessors :";
-                    for(auto el : node.predecessors)
-                        errs() << ' ' << el;
-                    errs() << "]\n";
-                    break;
-
-                case CfgNodeTy::TRANSFER :
-                    errs() << "Transfer Point => [" 
-                           << node.instPtr->getParent()->getName() 
-                           << "]" << (*node.instPtr) << "\t[Predecessor : " 
-                           << node.predecessors[0] << "]\n";
-                    break;
-
-                case CfgNodeTy::CONFLUENCE :
-                    errs() << "Confluence Point => [Predecessors Nodes :";
-                    for(auto el : node.predecessors)
-                        errs() << ' ' << el << '('
-                               << CFG[el].instPtr->getParent()->getName()
-                               << ')';
-                    errs() << "]\n";
-
-                    break;
-            }
-        }
-        errs() << "\n\n";
-    }
-
     /**
      * @brief Prints a partition in readable format.
      * 
      * @param[in]   partition   The partition vector to 
      *                          be printed.
+     * @param[in]   indexer     Indexing of the expressions in the
+     *                          partition.
      * @return      Void
      * 
-     * @see     IndexExp, Partitions
+     * @see     Indexer, Partitions
      **/
-    void printPartition(std::vector<int> const &partition) {
+    void printPartition(Partition const &partition, ExpressionIndexer const &indexer) {
         // if any index stores -1, then the whole vector
         // stores -1, representing the TOP element
         if(partition[0] == -1) {
@@ -620,456 +738,2843 @@ namespace HerbrandPass {
             return;    
         }
 
-        int cnt = 0;
-        // finding equivalent expressions in `mp` map
-        std::map<int, std::vector<ExpressionTy>> mp;
-        for(auto &el : IndexExp)
-            mp[partition[el.second]].push_back(el.first), cnt++;
+        // sorting the expressions by their set identifiers brings
+        // each equivalence class together, in the order of indexes
+        std::vector<std::pair<int, int>> entries(indexer.size());
+        for(int i = 0; i < indexer.size(); i++)
+            entries[i] = {partition[i], i};
+        std::sort(entries.begin(), entries.end());
 
         // print the equivalence classes along with their
         // set identifiers
-        for(auto &el : mp) {
-            errs() << '[' << el.first << "]{";
+        for(int k = 0; k < (int)entries.size(); k++) {
+            int setId = entries[k].first;
+            if(k == 0 or entries[k - 1].first != setId) errs() << '[' << setId << "]{";
+            else errs() << ", ";
 
-            int sz = el.second.size();
-            for(int i = 0; i < sz; i++) {
-                printExpression(el.second[i]); 
-                if(i != sz - 1) errs() << ", ";
-            }
+            printExpression(indexer.expression(entries[k].second));
 
-            errs() << "}, ";
+            if(k + 1 == (int)entries.size() or entries[k + 1].first != setId) errs() << "}, ";
         }
     }
 
     /**
-     * @brief Checks whether two partitions are same.
-     * 
+     * @brief
+     *  State of Herbrand Equivalence analysis of a function,
+     *  along with the functions computing it.
+     *
      * @details
-     *  Two partitions are same if in the vectors representing
-     *  them values at two indexes are equal in the first 
-     *  vector iff they are equal in the second vector.
-     * 
-     * @param[in]   first   First partition
-     * @param[in]   second  Second partition
-     * @return      Returns true if the two partitions are same,
-     *              otherwise false
-     * 
-     * @see     IndexExp, Partitions
+     *  An object is created for each function being analysed and
+     *  nothing is shared between two objects, so different
+     *  functions can be analysed at the same time from different
+     *  threads. The fixpoint is computed by calling `createCFG` 
+     *  and then `HerbrandAnalysis`.
+     *
+     * @see     HerbrandAnalysis, HerbrandEquivalenceAnalysis
      **/
-    bool samePartition(std::vector<int> const &first, std::vector<int> const &second) {
-        // map to store equivalent indexes (have same value) 
-        // in the first partition
-        std::map<int, std::vector<int>> mp;
-        for(int i = 0; i < (int)first.size(); i++)
-            mp[first[i]].push_back(i);
-
-        // checking if equivalent indexes in the first 
-        // partition are also equivalent in the second.
-        // If not `false` is returned
-        for(auto &el : mp) {
-            int elSetId = second[el.second[0]];
-            for(auto &nel : el.second)
-                if(second[nel] != elSetId) return false;
-        }
-
-        // the partitions are equivalent, so return `true`
-        return true;
-    }
+    class AnalysisContext {
+    public:
+        /** 
+         * @brief 
+         *  Constants used in the program, numbered in the order
+         *  they are first seen.
+         *
+         * @note 
+         *  Value is LLVM structure used for representing
+         *  constants and variables.
+         * 
+         * @see     InternMapVector, llvm::Value
+         **/
+        InternMapVector<Value *> Constants;
+    
+        /** 
+         * @brief 
+         *  Variables used in the program, numbered in the order
+         *  they are first seen.
+         *
+         * @note 
+         *  Value is LLVM structure used for representing
+         *  constants and variables.
+         * 
+         * @see     InternMapVector, llvm::Value
+         **/
+        InternMapVector<Value *> Variables;
 
-    /**
-     * @brief 
-     *  Returns set identifier for a given two length expression 
-     *  at a program point.
-     * 
-     * @details
-     *  With the help of `Parent` map, first a check is made if 
-     *  a set identifier representing the expression at the
-     *  current program point exists. If so it is returned else
-     *  a new set identifier is created by updating `SetCnt` and
-     *  returned. This information is also stored in the 
-     *  `Parent` map for future use.
-     * 
-     * @param[in]   partition   Vector representing the partition 
-     *                          at the program point.
-     * @param[in]   exp         Expression whose set identifier is
-     *                          required at the program point.
-     * @return      The set identifier for the expression at the 
-     *              program point.
-     * 
-     * @note    Make sure that the second argument passed represents a 
-     *          length two expression.
-     * 
-     * @see     IndexExp, Parent, Partitions, SetCnt
-     **/
-    int findSet(std::vector<int> const &partition, ExpressionTy const &exp) {
-        // operator and set identifiers corresponding to left and right 
-        // subexpressions at the current program point 
-        char op = std::get<0>(exp);
-        int leftSetId = partition[IndexExp[EXP(std::get<1>(exp))]];
-        int rightSetId = partition[IndexExp[EXP(std::get<2>(exp))]];
-
-        // checking if a set representing the expression
-        // already exists
-        std::tuple<char, int, int> tup = {op, leftSetId, rightSetId};
-        auto it = Parent.find(tup);
-
-        // if the set already exists return its identifier,
-        // otherwise return new set identifier and update
-        // `Parent` map with this information
-        if(it == Parent.end()) return Parent[tup] = SetCnt++;
-
-        return it->second;
-    }
+        /**
+         * @brief
+         *  Maps expressions to integer indexes and back. This
+         *  indexing is fixed in the beginning and used throughout
+         *  wherever indexing is required for the expressions.
+         * 
+         * @see     ExpressionIndexer, Partitions
+         **/
+        ExpressionIndexer Indexer;
 
-    /**
-     * @brief Finds initial partition.
-     * 
-     * @details
-     *  Finds a vector representing initial partition
-     *  in which all expressions are in different 
-     *  partition (has non-equivalent set identifiers).
-     *  It also updates `Parent` map for set identifiers
-     *  assigned to length two expressions.
-     * 
-     * @param[out]  partition   Vector to store the 
-     *                          initial partition.
-     * @return      Void
-     * 
-     * @see     findSet, IndexExp, Partitions
-     **/
-    void findInitialPartition(std::vector<int> &partition) {
-        // create new IDstruct object for each epxression.
-        // For length two expressions this is done indirectly
-        // by calling `findSet` function which also updates
-        // `Parent` map
-        for(auto &el : IndexExp) {
-            if(std::get<0>(el.first) == '\0') partition[el.second] = SetCnt++;
-            else partition[el.second] = findSet(partition, el.first);
-        }
-    }
+        /**
+         * @brief
+         *  Reverse index from constants and variables to the
+         *  length two expressions using them.
+         *
+         * @details
+         *  `UsedBy[i]` holds the indexes of the length two
+         *  expressions which have the constant or variable with
+         *  index `i` as one of their operands. After an assignment
+         *  only these expressions can get a new set identifier.
+         *
+         * @see     Indexer, transferFunction
+         **/
+        std::vector<std::vector<int>> UsedBy;
 
-    /**
-     * @brief
-     *  Returns equivalence class of an expression at a 
-     *  given program point.
-     * 
-     * @details
-     *  The equivalence class is the set of indexes corresponding
-     *  to expressions (as given by `IndexExp`) which have same
-     *  set identifiers as the index representing the expression 
-     *  (passed as parameter) in the partition at the program point.
-     *  
-     *
-     * @param[in]   partition   Vector representing the partition
-     *                          at current program point.
-     * @param[in]   expIdx      Index of expression whose equivalence
-     *                          class is required.
-     * @param[out]  expClass    Set containing identifiers corresponding
-     *                          to the required equivalence class.
-     * @return      Void
-     * 
-     * @see     IndexExp, Partitions
-     **/
-    void getClass(std::vector<int> const &partition, int expIdx, 
-                  std::set<int> &expClass) {
+        /**
+         * @brief
+         *  Counter to keep track of set identifiers. New set 
+         *  identifiers are created by incrementing this counter.
+         * 
+         * @see     ExpressionTy, Partitions
+         **/
+        int SetCnt = 0;
 
-        expClass.clear();
-        int expSetId = partition[expIdx];
+        /**
+         * @brief   Number of set identifiers left by the last compaction.
+         *
+         * @see     compact, maybeCompact
+         **/
+        int LiveSetCnt = 0;
 
-        for(int i = 0; i < (int)IndexExp.size(); i++) {
-            if(expSetId == partition[i])
-                expClass.insert(i);
-        }
-    }
+        /**
+         * @brief
+         *  Vector to keep track of equivalence classes at the exit
+         *  of each node of the basic block graph.
+         * 
+         * @details
+         *  There is an entry for each node of `Blocks` in this vector
+         *  which itself is a `Partition` containing an entry for each
+         *  expression of length atmost two. The entries for the 
+         *  expressions contains integer set identifiers. For a
+         *  given program point two expressions are equivalent iff
+         *  they have the same set identifier. Partitions at the
+         *  program points inside a basic block are not kept, they
+         *  are found from the partition at its entry when needed.
+         *
+         * @note
+         *  For a normal program point the entries for expressions
+         *  in the `Partitions` vector are non-negative. But, if the 
+         *  partition represents TOP partition, the entries for all
+         *  the expressions are -1. And the entry for any expression
+         *  being -1 is sufficient to conclude that the partition
+         *  vector represents TOP partition.
+         *  A partition copied from a predecessor shares its storage
+         *  except for the leaves where it differs, so memory grows
+         *  with the number of changes made along the function rather
+         *  than with the number of basic blocks.
+         * 
+         * @see     Blocks, EntryPartitions, Indexer, Partition, partitionAt, SetCnt
+         **/
+        std::vector<Partition> Partitions;
 
-    /**
-     * @brief Transfer function associated with Herbrand analysis.
-     * 
-     * @param[in]   cfgIndex    Control flow graph node index on which 
-     *                          transfer function is applied. The 
-     *                          function modifies `Partitions[cfgIndex]`.
-     * @returns     Void
-     * 
-     * @see     findSet, IndexExp, Partitions
-     **/
-    void transferFunction(int cfgIndex) {
-        // current partition vector
-        std::vector<int> &partition = Partitions[cfgIndex];
-
-        // first copy predecessor partition into current partition
-        partition = Partitions[CFG[cfgIndex].predecessors[0]];
-
-        // if the current partition has any index with value -1, it 
-        // means that it represents the TOP element and it has to be
-        // left as such without any modifications
-        if(partition[0] == -1) return;
-
-        // if the node is the END CFG node, return
-        if(CFG[cfgIndex].NodeTy == CfgNodeTy::END) return;
-
-        // `changedExp` is expression (ie. a variable) which
-        // has been assigned value and `changedToExp` is the 
-        // expression which has been assigned to it. If 
-        // operator in `changedToExp` is `#` - it symbolises
-        // non-deterministic assignment
-        Instruction *inst = CFG[cfgIndex].instPtr;
-        ExpressionTy changedExp, changedToExp;
-
-        if(isa<LoadInst>(inst)) {
-            changedExp = EXP(inst);
-            changedToExp = EXP(inst->getOperand(0));
-        } else if(isa<StoreInst>(inst)) {
-            changedExp = EXP(inst->getOperand(1));
-            changedToExp = EXP(inst->getOperand(0));
-        } else if(isa<BinaryOperator>(inst)) {
-            char op = getOpSymbol(inst->getOpcodeName());
-            Value *leftOp = inst->getOperand(0);
-            Value *rightOp = inst->getOperand(1);
-            changedExp = EXP(inst);
-            changedToExp = {op, leftOp, rightOp};
-        } else if(isa<CallInst>(inst)) {
-            changedExp = EXP(inst);
-            // here `#` symbolises non-deterministic assignment
-            changedToExp = {'#', nullptr, nullptr};
-        } else {
-            // in this case the current instruction has not
-            // modified the partition, so the function returns
-            return;
-        }
+        /**
+         * @brief
+         *  Vector to keep track of equivalence classes at the entry
+         *  of each node of the basic block graph.
+         *
+         * @details
+         *  Only nodes with more than one predecessor, whose entry is
+         *  a confluence point, have a non-empty entry here. The entry
+         *  of any other node is the exit of its predecessor.
+         *
+         * @see     Blocks, Partitions
+         **/
+        std::vector<Partition> EntryPartitions;
 
-        if(std::get<0>(changedToExp) == '#') {
-            // if it is a non-deterministic assignment, 
-            // then create a new set identifier
-            partition[IndexExp[changedExp]] = SetCnt++;
-        } else {
-            // assign the `changedExp`, the set identifier of 
-            // `changedToExp`
-            partition[IndexExp[changedExp]] = partition[IndexExp[changedToExp]];
-        }
+        /**
+         * @brief
+         *  Open addressing hash map to hold parent set identifiers.
+         * 
+         * @details
+         *  a1 =~ a2 and b1 =~ b2 at a program point iff
+         *  (a1 + b1) =~ (a2 + b2). Parent map helps us 
+         *  to resolve this by storing set identifiers of 
+         *  compound expression (a1 + b1) as parent of set 
+         *  identifiers of its smaller sub-expressions (a1 
+         *  and b1). Now, later when a new expression is 
+         *  formed by combining expressions (a2 and b2) with 
+         *  same set identifiers as those of the two 
+         *  sub-expressions (a1 and b1), we assign it 
+         *  (a2 + b2) the same identifier as the previous 
+         *  compound expression (a1 + b1).
+         *  This map also helps to resolve other complex 
+         *  cases where some equivalence classes are lost in 
+         *  the middle of the program but appears later.
+         *  
+         * @note
+         *  The key of this map packs the operator along with the
+         *  two set identifiers (which are ordered) using `packKey`.
+         *  Also this map is shared by all the program points.
+         * 
+         * @see     FlatHashMap, Indexer, packKey, Partitions, SetCnt
+         **/
+        FlatHashMap Parent;
 
-        // update set identifiers for two length expressions 
-        // involving `changedExp`. Here set identifiers of all 
-        // two length expressions are assigned values, but only
-        // those involving `changedExp` are updated
-        for(auto &el : IndexExp) {
-            if(std::get<0>(el.first) == '\0') continue;
-            partition[el.second] = findSet(partition, el.first);
-        }
-    }
+        /**
+         * @brief
+         *  Hash of the `Parent` entries made by `confluenceClosure`
+         *  at the entry of each node of `Blocks` on its last 
+         *  evaluation, in sparse mode.
+         *
+         * @details
+         *  The implicit classes at a confluence point can change 
+         *  while its partition stays same, so in sparse mode a 
+         *  confluence point has changed iff its partition or this
+         *  hash has changed.
+         *
+         * @see     confluenceClosure, SparseMode
+         **/
+        std::vector<uint64_t> ClosureSignature;
 
-    /**
-     * @brief Confluence function associated with Herbrand analysis.
-     * 
-     * @param[in]   cfgIndex    Control flow graph node index on 
-     *                          which confluence function is applied.
-     * @returns     Void
-     * 
-     * @see     findSet, IndexExp, Partitions
-     **/
-    void confluenceFunction(int cfgIndex) {
-        // vector of  predecessor CFG node indexes
-        std::vector<int> &predecessors = CFG[cfgIndex].predecessors;
+        /**
+         * @brief
+         *  Control flow graph corresponding to the program.
+         * 
+         * @details
+         *  It contains nodes only corresponding to reachable
+         *  instructions and confluence points along with two
+         *  special START and END nodes.
+         * 
+         * @see     CfgNodeTy, createCFG
+         **/
+        std::vector<CfgNodeTy> CFG;
+
+        /**
+         * @brief Stores `CFG` index for each instruction.
+         * 
+         * @see     CFG, CfgNodeTy
+         **/
+        std::map<Instruction *, int> CfgIndex;
+
+        /**
+         * @brief
+         *  Basic block graph corresponding to the program.
+         *
+         * @details
+         *  Partitions are kept only at the entry and exit of these
+         *  nodes, and the transfer functions of the instructions in
+         *  a basic block are applied one after another in a single
+         *  step. `CFG` is still used for numbering program points.
+         *
+         * @see     BlockNodeTy, CFG, createCFG
+         **/
+        std::vector<BlockNodeTy> Blocks;
+
+        /**
+         * @brief Stores `Blocks` index for each reachable basic block.
+         *
+         * @see     Blocks
+         **/
+        DenseMap<BasicBlock *, int> BlockIndex;
+
+        /**
+         * @brief 
+         *  Sets up `Indexer` for expressions of length atmost
+         *  two. Also Initialises `Constants` and `Variables` by
+         *  looking through the instructions in the program and
+         *  fills the reverse index `UsedBy`.
+         * 
+         * @param[in]   F     Function block over which 
+         *                    we are operating
+         * @returns     Void
+         * 
+         * @see     Constants, Indexer, UsedBy, Variables
+         **/
+        void assignIndex(Function &F) {
+            HERBRAND_TIMER(timer, Stats, "assignIndex");
+
+            ////////////////////////////////////////////////////
+            // First update `Constants` and `Variables` sets by
+            // iterating over instructions in the program
+            ////////////////////////////////////////////////////
+
+            // constants and variables in the order they are first
+            // seen, so that the indexing (and the set identifiers)
+            // does not depend on where the values are in memory
+            std::vector<Value *> values;
         
-        // if all the predecessors partition represents TOP 
-        // element then their confluence is also TOP element.
-        // So, the current partition need not be modified as
-        // by initialisation the current partition should also
-        // hold TOP partition
-        bool cont = false;
-        for(int pred : predecessors)
-            cont |= (Partitions[pred][0] != -1);
-        if(not cont) return;
-
-        // the current partition
-        std::vector<int> &partition = Partitions[cfgIndex];
-
-        // to check which expressions has already been processed
-        std::vector<bool> accessFlag(IndexExp.size(), false);
-
-        // process all the expressions one by one
-        for(auto &el : IndexExp) {
-            int elIdx = el.second;
-
-            // continue if the expression is already processed
-            if(accessFlag[elIdx]) continue;
-
-            // mark it as processed
-            accessFlag[elIdx] = true;
-
-            // if the set identifier for the expression in all
-            // the predecessors is same it is assigned the same
-            // set identifier; else a new set identifier is 
-            // created and assigned to all the expressions which
-            // belongs to the same equivalence class as the 
-            // current expression across all the predecessors and
-            // they are also marked processed
-            int elSetId = -1;
-            bool flag = true;
-            for(int pred : predecessors) {
-                int elSetIdPred = Partitions[pred][elIdx];
-                if(elSetIdPred == -1) continue;
-                else if(elSetId == -1) elSetId = elSetIdPred;
-                else if(elSetId != elSetIdPred) flag = false;
+            for(Instruction &I : instructions(&F)) {
+                // if the instruction is not of void type then 
+                // it represents a variable. All the variables
+                // will be covered in this case
+                if(not I.getType()->isVoidTy() and Variables.insert(&I).second) 
+                    values.push_back(&I);
+
+                // now we iterate over its operands to find the 
+                // constants, this case won't add any extra variables
+                // Also, we should skip alloca instruction as its
+                // operands doesn't contain any constant that
+                // concerns us
+                if(isa<AllocaInst>(&I)) continue;
+                for(int i = 0; i < (int)I.getNumOperands(); i++) {
+                    Value *value = I.getOperand(i);
+                    if(dyn_cast<ConstantInt>(value) and Constants.insert(value).second)
+                        values.push_back(value);
+                }
             }
 
-            if(flag) partition[elIdx] = elSetId;
-            else {
-                std::set<int> intersection, elClassPred;
-                for(int i = 0; i < (int)IndexExp.size(); i++)
-                    intersection.insert(i);
-                
-                for(int pred : predecessors) {
-                    getClass(Partitions[pred], elIdx, elClassPred);
-                    setIntersect<int>(intersection, elClassPred);
-                }
+            ////////////////////////////////////////////////////
+            // Now set up `Indexer` for expressions of length 
+            // atmost two
+            ////////////////////////////////////////////////////
 
-                int newSetId = SetCnt++;
-                for(int nel : intersection)
-                    accessFlag[nel] = true, partition[nel] = newSetId;
-            }
-        }
+            if(SparseMode) {
+                // only the length two expressions appearing in the 
+                // function, whose operator and operands are tracked
+                Indexer.init(values, Ops);
 
-        // now update `Parent` map
-        for(auto &el : IndexExp) {
-            char op = std::get<0>(el.first);
-            if(op == '\0') continue;
-            
-            int leftSetID = partition[IndexExp[EXP(std::get<1>(el.first))]];
-            int rightSetID = partition[IndexExp[EXP(std::get<2>(el.first))]];
+                std::vector<ExpressionTy> exps;
+                for(Instruction &I : instructions(&F)) {
+                    if(not isa<BinaryOperator>(&I)) continue;
 
-            auto tup = std::make_tuple(op, leftSetID, rightSetID);
-            // this assertion must be passed for the consistency of the algorithm
-            assert(Parent.find(tup) == Parent.end() or 
-                   Parent[tup] == partition[el.second]);
+                    ExpressionTy exp(getOpSymbol(I.getOpcodeName()), 
+                                     I.getOperand(0), I.getOperand(1));
+                    if(Indexer.index(exp) != -1) exps.push_back(exp);
+                }
 
-            Parent[tup] = partition[el.second];
-        }
-    }
+                Indexer.initSparse(values, Ops, exps);
+            } else Indexer.init(values, Ops);
 
-    /**
-     * @brief Main Herbrand analysis function.
-     * 
-     * @returns     Void
-     * 
-     * @see     Partitions, IndexExp, Parent
-     **/
-    void HerbrandAnalysis(Function &F) {
-        PRINT_HEADER("Herbrand Equivalence Computation");
-        errs() << "\n";
+            // record each length two expression against its operands,
+            // an expression with the same operand on both the sides
+            // is recorded once
+            UsedBy.assign(Indexer.numValues(), {});
+            for(int i = Indexer.numValues(); i < Indexer.size(); i++) {
+                int leftIdx = Indexer.leftIndex(i), rightIdx = Indexer.rightIndex(i);
 
-        // assign index to expressions arbitrarily
-        assignIndex(F);
+                UsedBy[leftIdx].push_back(i);
+                if(rightIdx != leftIdx) UsedBy[rightIdx].push_back(i);
+            }
+        }
+
+        /**
+         * @brief
+         *  Creates control flow graph corresponding to
+         *  the program.
+         * 
+         * @see     CfgNodeTy, CFG
+         **/
+        void createCFG(Function &F) {
+            HERBRAND_TIMER(timer, Stats, "createCFG");
 
-        // initialise partition vector with -1 for each program
-        // points and each expression - this stands for TOP 
-        // partition at each program point. Note that any element
-        // of partition vector being -1 means that whole vector
-        // holds -1 and represents TOP partition
-        Partitions.assign(CFG.size(), 
-                          std::vector<int>(IndexExp.size(), -1));
+            ////////////////////////////////////////////////////
+            // First find the set of reachable basic blocks by
+            // performing BFS from the starting basic block
+            ////////////////////////////////////////////////////
+        
+            std::set<BasicBlock *> reachableBB;
+            std::queue<BasicBlock *> q;
 
-        // initialise starting partition for START node
-        findInitialPartition(Partitions[0]);
+            // the list of basic blocks in the same order as
+            // visited by BFS, for same traversal later again
+            std::vector<BasicBlock *> bfsOrder;
 
-        PRINT_HEADER("Initial Partition");
-        printPartition(Partitions[0]);
-        errs() << "\n\n\n";
+            // mark the starting basic block as reachable
+            // and also push it into the queue for BFS
+            q.push(&F.front()), reachableBB.insert(&F.front());
 
-        bool converged = false;
-        int iterationCtr = 0;
+            while(not q.empty()) {
+                BasicBlock *bb = q.front();
+                q.pop(), bfsOrder.push_back(bb);
 
-        // repeat while convergence
-        while(not converged) {
-            PRINT_HEADER("Iteration " + std::to_string(++iterationCtr));
-            converged = true;
+                for(BasicBlock *nbb : successors(bb)) {
+                    if(reachableBB.find(nbb) == reachableBB.end())
+                        reachableBB.insert(nbb), q.push(nbb);
+                }
+            }
 
-            // for all program points (nodes in CFG) except
-            // START apply transfer/confluence function as
-            // applicable
-            for(int i = 1; i < (int)CFG.size(); i++) {
-                std::vector<int> oldPartition = Partitions[i];
-                std::vector<int> &predecessors = CFG[i].predecessors;
-                Instruction *inst = CFG[i].instPtr;
+            ////////////////////////////////////////////////////
+            // Now again visit the basic blocks in the same 
+            // order assigning an index for nodes in the control
+            // flow graph vector `CFG` corresponding to
+            // instructions and confluence points
+            ////////////////////////////////////////////////////
+
+            // some basic blocks might have just one
+            // predecessor, in that case they don't require
+            // a confluence node in the control flow graph.
+            // This set keeps track of all the basic blocks
+            // that require a confluence node
+            std::set<BasicBlock *> confBlocks;
+
+            // keeps track of current `CFG` index. Index 0 is
+            // assigned to the starting node
+            int curCfgIndex = 1;
+
+            for(BasicBlock *bb : bfsOrder) {
+                // number of predecessor basic blocks of `bb`,
+                // which are reachable
+                int predSz = 0;
+                for(BasicBlock *nbb : predecessors(bb)) {
+                    if(reachableBB.find(nbb) != reachableBB.end())
+                        predSz++;
+                }
 
-                errs() << '[' << i << "] : ";
+                // if this basic block requires a confluence node,
+                // first assign an index to it
+                if(predSz > 1)
+                    confBlocks.insert(bb), curCfgIndex++;
+            
+                // now assign nodes for the instructions in the
+                // basic block
+                for(Instruction &I : (*bb))
+                    CfgIndex[&I] = curCfgIndex++;
+            }
 
-                bool isConfluence = (CFG[i].NodeTy == CfgNodeTy::CONFLUENCE);
-                if(CFG[i].NodeTy == CfgNodeTy::END and predecessors.size() > 1)
-                    isConfluence = true;
-
-                if(isConfluence) {
-                    // if CFG node corresponds to a confluence point
-                    if(CFG[i].NodeTy == CfgNodeTy::CONFLUENCE)
-                        errs() << "Confluence Point => ";
-                    else errs() << "END => ";
-                    
-                    errs() << "[Predecessors :";
-                    for(auto el : predecessors) {
-                        errs() << ' ' << el << '(' 
-                               << CFG[el].instPtr->getParent()->getName() 
-                               << ')';
+            ////////////////////////////////////////////////////
+            // Now actually create control flow graph nodes by
+            // filling `CFG` vector. Note that the consistency
+            // between `CfgIndex` and actual index of node for
+            // instructions in `CFG` vector is implicitly 
+            // maintained
+            ////////////////////////////////////////////////////
+
+            // START node
+            CFG.push_back({CfgNodeTy::START, nullptr, std::vector<int>(), std::vector<int>()});
+
+            // `CFG` nodes that are predecessors of the special END
+            // END instruction. Last instruction of the basic blocks 
+            // that have no successors belong to this category. Only
+            // if this vector is non-empty, an END node is created
+            std::vector<int> predsEnd;
+
+            for(auto bb : bfsOrder) {
+                // holds index of predecessor nodes for instructions
+                // in this block
+                int predIndex;
+
+                // if the block requires a confluence point,
+                // first push it into the `CFG` vector
+                if(confBlocks.find(bb) != confBlocks.end()) {
+                    std::vector<int> preds;
+                    for(BasicBlock *nbb : predecessors(bb)) {
+                        if(reachableBB.find(nbb) != reachableBB.end())
+                            preds.push_back(CfgIndex[&nbb->back()]);
                     }
-                    errs() << "]\n\t";
+                    CFG.push_back({CfgNodeTy::CONFLUENCE, nullptr, preds, std::vector<int>()});
 
-                    confluenceFunction(i);
+                    // initialise `predIndex`
+                    predIndex = CFG.size() - 1;
                 } else {
-                    // if CFG node corresponds to a transfer point
+                    // here only `predIndex` is 
+                
+                    // this initialisation is for the first basic block
+                    // for which the `if` condition inside `for` never
+                    // becomes true
+                    predIndex = 0;
+
+                    for(BasicBlock *nbb : predecessors(bb))
+                        if(reachableBB.find(nbb) != reachableBB.end()) {
+                            // if `break` is removed, even then the `if` 
+                            // block should be entered only once (except
+                            // for the first basic block for which it is 
+                            // entered never)
+                            predIndex = CfgIndex[&nbb->back()];
+                            break;
+                        }
+                }
 
-                    if(CFG[i].NodeTy == CfgNodeTy::TRANSFER) {
-                        errs() << "Transfer Point => ["
-                               << inst->getParent()->getName() << "] "
-                               << (*inst) << ' ';
-                    } else errs() << "END => ";
+                // now insert nodes corresponding to the instructions
+                for(Instruction &I : (*bb)) {
+                    CFG.push_back({CfgNodeTy::TRANSFER, &I, 
+                                   std::vector<int>({predIndex}), std::vector<int>()});
 
-                    errs() << "[Predecessors : " << predecessors[0] << "]\n\t";
+                    // update `predIndex`
+                    predIndex = CFG.size() - 1;
 
-                    transferFunction(i);
+                    // this assertion must be passed for consistency
+                    // of this function
+                    assert(predIndex == CfgIndex[&I]);
                 }
 
-                printPartition(Partitions[i]);
-                errs() << "\n\n";
+                if(succ_empty(bb)) predsEnd.push_back(CfgIndex[&bb->back()]);
+            }
 
-                // update convergence flag
-                if(not samePartition(oldPartition, Partitions[i]))
-                    converged = false;
+            // now create node corresponding to END, if required
+            if(not predsEnd.empty()) {
+                CFG.push_back({CfgNodeTy::END, nullptr, predsEnd, std::vector<int>()});
             }
-            errs() << "\n\n";
+
+            // fill successors of each node from its predecessors
+            for(int i = 0; i < (int)CFG.size(); i++)
+                for(int pred : CFG[i].predecessors)
+                    CFG[pred].successors.push_back(i);
+
+            ////////////////////////////////////////////////////
+            // Finally create the basic block graph, with nodes
+            // in the same order as the `CFG` nodes
+            ////////////////////////////////////////////////////
+
+            Blocks.push_back({BlockNodeTy::START, nullptr, 0, {}, {}});
+            for(BasicBlock *bb : bfsOrder) {
+                BlockIndex[bb] = Blocks.size();
+                int cfgIndex = CfgIndex[&bb->front()];
+                if(confBlocks.find(bb) != confBlocks.end()) cfgIndex--;
+                Blocks.push_back({BlockNodeTy::BLOCK, bb, cfgIndex, {}, {}});
+            }
+
+            for(BasicBlock *bb : bfsOrder) {
+                std::vector<int> &preds = Blocks[BlockIndex[bb]].predecessors;
+                for(BasicBlock *nbb : predecessors(bb))
+                    if(reachableBB.find(nbb) != reachableBB.end())
+                        preds.push_back(BlockIndex[nbb]);
+                if(bb == &F.front()) preds.push_back(0);
+            }
+
+            if(not predsEnd.empty()) {
+                std::vector<int> preds;
+                for(int pred : predsEnd) 
+                    preds.push_back(BlockIndex[CFG[pred].instPtr->getParent()]);
+                Blocks.push_back({BlockNodeTy::END, nullptr, (int)CFG.size() - 1, preds, {}});
+            }
+
+            for(int i = 0; i < (int)Blocks.size(); i++)
+                for(int pred : Blocks[i].predecessors)
+                    Blocks[pred].successors.push_back(i);
         }
-    }
+    
+        /**
+         * @brief 
+         *  Prints the control flow graph corresponding to 
+         *  the program
+         * 
+         * @returns     Void
+         * 
+         * @see     CFG, CfgNodeTy
+         **/
+        void printCFG() {
+            PRINT_HEADER("CONTROL FLOW GRAPH");
+            errs() << "\n";
 
-    /**
-     * @brief Body of the pass
-     **/
-    struct HerbrandPass : public FunctionPass {
-        // LLVM uses ID’s address to identify a pass
-        static char ID;
+            for(int i = 0; i < (int)CFG.size(); i++) {
+                CfgNodeTy &node = CFG[i];
+                errs() << '[' << i << "] : ";
 
-        // constructor - calls base class constructor
-        HerbrandPass() : FunctionPass(ID) {}
+                switch(node.NodeTy) {
+                    case CfgNodeTy::START :
+                        errs() << "START\n";
+                        break;
 
-        // the function pass
-        bool runOnFunction(Function &F) override {
-            // clear the contents of global variables
-            Constants.clear(), Variables.clear();
-            IndexExp.clear(), Partitions.clear();
-            Parent.clear(), CFG.clear(), CfgIndex.clear();
-            SetCnt = 0;
+                    case CfgNodeTy::END :
+                        errs() << "END  [Predecessors :";
+                        for(auto el : node.predecessors)
+                            errs() << ' ' << el;
+                        errs() << "]\n";
+                        break;
 
-            // assign names to variables; create control flow graph
-            assignNames(F), createCFG(F);
-            printCode(F), printCFG();
+                    case CfgNodeTy::TRANSFER :
+                        errs() << "Transfer Point => [" 
+                               << node.instPtr->getParent()->getName() 
+                               << "]" << (*node.instPtr) << "\t[Predecessor : " 
+                               << node.predecessors[0] << "]\n";
+                        break;
 
-            // perform Herbrand Analysis
-            HerbrandAnalysis(F);
+                    case CfgNodeTy::CONFLUENCE :
+                        errs() << "Confluence Point => [Predecessors Nodes :";
+                        for(auto el : node.predecessors)
+                            errs() << ' ' << el << '('
+                                   << CFG[el].instPtr->getParent()->getName()
+                                   << ')';
+                        errs() << "]\n";
 
-            // return false, because the pass is not making changes
-            // in the input file
-            return false;
-        }
-    };
-}
+                        break;
+                }
+            }
+            errs() << "\n\n";
 
-// initialse static variable ID and register the pass
+            errs() << "Basic block graph\n";
+            for(int i = 0; i < (int)Blocks.size(); i++) {
+                BlockNodeTy &node = Blocks[i];
+                errs() << '[' << i << "] : ";
+
+                if(node.NodeTy == BlockNodeTy::START) errs() << "START";
+                else if(node.NodeTy == BlockNodeTy::END) errs() << "END";
+                else errs() << "Block => [" << node.bbPtr->getName() << ']';
+
+                errs() << "\t[CFG Index : " << node.cfgIndex << "] [Predecessors :";
+                for(auto el : node.predecessors) errs() << ' ' << el;
+                errs() << "]\n";
+            }
+            errs() << "\n\n";
+        }
+
+        /**
+         * @brief
+         *  Scratch space used by `samePartition` for relabelling 
+         *  set identifiers of the two partitions being compared.
+         *
+         * @details
+         *  `CanonicalLabel[k][id]` holds `{stamp, label}` for the set 
+         *  identifier `id` in the `k`th partition. A label is valid 
+         *  only if its stamp equals `CanonicalStamp`, which is 
+         *  incremented on every comparison, so the vectors never have
+         *  to be cleared.
+         *
+         * @see     samePartition
+         **/
+        std::vector<std::pair<int, int>> CanonicalLabel[2];
+
+        /**
+         * @brief Current stamp for `CanonicalLabel` entries.
+         *
+         * @see     CanonicalLabel, samePartition
+         **/
+        int CanonicalStamp = 0;
+
+        /**
+         * @brief   Number of threads used by `solveWavefront`.
+         **/
+        int NumThreads = 1;
+
+        /**
+         * @brief   Number of nodes processed while computing the fixpoint.
+         **/
+        struct CountersTy {
+            int Iterations = 0, Transfers = 0, Confluences = 0;
+        };
+
+        /**
+         * @brief   Nodes processed while computing the fixpoint.
+         **/
+        CountersTy Counters;
+
+#if HERBRAND_STATS
+        /**
+         * @brief
+         *  Counters and timers of the analysis, compiled in only with
+         *  `HERBRAND_STATS`. The nodes counted are the basic blocks.
+         *
+         * @see     reportStats, SolverStatsTy
+         **/
+        SolverStatsTy Stats;
+#endif
+
+        /**
+         * @brief
+         *  State of a worker solving a strongly connected component
+         *  of the basic block graph in wavefront mode.
+         *
+         * @details
+         *  Components of the same wavefront are solved at the same 
+         *  time and must not see the changes made by each other, so
+         *  while a wavefront is solved `Parent` and `SetCnt` are only
+         *  read. A worker makes its `Parent` entries in its own map,
+         *  which is looked up before `Parent`, and creates provisional
+         *  set identifiers counting from `SetCnt`. Once the wavefront
+         *  is solved `commitWorker` replaces them by set identifiers
+         *  of the context.
+         *
+         * @see     commitWorker, solveWavefront
+         **/
+        struct WorkerTy {
+            /**
+             * @brief   Nodes of the component, in the order of their priority.
+             **/
+            std::vector<int> Nodes;
+
+            /**
+             * @brief   `Parent` entries made by the worker.
+             **/
+            FlatHashMap Parent;
+
+            /**
+             * @brief
+             *  First provisional set identifier, and the one to be
+             *  created next.
+             **/
+            int Base = 0, SetCnt = 0;
+
+            /**
+             * @brief
+             *  For each provisional set identifier, the `Parent` key
+             *  for which `findSet` created it, or `~0` if it was 
+             *  created otherwise.
+             **/
+            std::vector<uint64_t> Origin;
+
+            /**
+             * @brief   Scratch space of `samePartition` for the worker.
+             *
+             * @see     CanonicalLabel, CanonicalStamp
+             **/
+            std::vector<std::pair<int, int>> CanonicalLabel[2];
+            int CanonicalStamp = 0;
+
+            /**
+             * @brief   Nodes processed by the worker.
+             **/
+            CountersTy Counters;
+
+#if HERBRAND_STATS
+            /**
+             * @brief   `findSet` lookups of the worker, see `SolverStatsTy`.
+             **/
+            long long FindSetHits = 0, FindSetMisses = 0;
+#endif
+        };
+
+        /**
+         * @brief
+         *  Creates a new set identifier, a provisional one if 
+         *  `worker` is not `nullptr`.
+         *
+         * @see     SetCnt, WorkerTy
+         **/
+        int allocSetId(WorkerTy *worker) {
+            if(not worker) return SetCnt++;
+
+            worker->Origin.push_back(~0ULL);
+            return worker->SetCnt++;
+        }
+
+        /**
+         * @brief
+         *  Returns the set identifier mapped to a key by `Parent`, or
+         *  by the map of `worker` if it is not `nullptr` and has the
+         *  key. Returns -1 if there is none.
+         *
+         * @see     Parent, WorkerTy
+         **/
+        int findParent(uint64_t key, WorkerTy const *worker) const {
+            if(worker) {
+                int setId = worker->Parent.find(key);
+                if(setId != -1) return setId;
+            }
+            return Parent.find(key);
+        }
+
+        /**
+         * @brief
+         *  Maps a key to a set identifier in `Parent`, or in the map
+         *  of `worker` if it is not `nullptr`.
+         *
+         * @see     Parent, WorkerTy
+         **/
+        void assignParent(uint64_t key, int setId, WorkerTy *worker) {
+            if(worker) worker->Parent.assign(key, setId);
+            else Parent.assign(key, setId);
+        }
+
+        /**
+         * @brief
+         *  Renumbers the set identifiers in use and drops the `Parent`
+         *  entries which can no longer be looked up.
+         *
+         * @details
+         *  Set identifiers are never reused, so one which is in no 
+         *  partition can come back only as the value of a `Parent` entry
+         *  whose operands are in use. The set identifiers in use are thus
+         *  those in the partitions, along with the values of the entries
+         *  whose operands are in use, and the other entries are dropped.
+         *  The set identifiers in use are numbered from 0 in their old
+         *  order, keeping the storage shared by the partitions.
+         *
+         * @note    Must not be called while a wavefront is being solved.
+         *
+         * @returns     Void
+         *
+         * @see     maybeCompact, Parent, Partition::remap, SetCnt
+         **/
+        void compact() {
+            std::vector<Partition *> partitions;
+            for(Partition &partition : Partitions)
+                partitions.push_back(&partition);
+            for(Partition &partition : EntryPartitions)
+                partitions.push_back(&partition);
+
+            std::vector<int> newId(SetCnt, -1);
+            Partition::forEachEntry(partitions, [&](int setId) {
+                if(setId >= 0) newId[setId] = 0;
+            });
+
+            // the value of an entry can itself be an operand of another
+            // entry, so this is repeated until nothing more is found
+            for(bool found = true; found; ) {
+                found = false;
+                Parent.forEach([&](uint64_t key, int setId) {
+                    if(newId[keyLeft(key)] == -1 or newId[keyRight(key)] == -1) return;
+                    if(newId[setId] == -1) newId[setId] = 0, found = true;
+                });
+            }
+
+            int liveCnt = 0;
+            for(int &setId : newId)
+                if(setId != -1) setId = liveCnt++;
+
+            FlatHashMap parent;
+            Parent.forEach([&](uint64_t key, int setId) {
+                int left = newId[keyLeft(key)], right = newId[keyRight(key)];
+                if(left != -1 and right != -1)
+                    parent.assign(packKey(keyOp(key), left, right), newId[setId]);
+            });
+            Parent = std::move(parent);
+
+            Partition::remap(partitions, [&](int setId) {
+                return setId < 0 ? setId : newId[setId];
+            });
+
+            for(auto &labels : CanonicalLabel)
+                labels.clear(), labels.shrink_to_fit();
+            SetCnt = LiveSetCnt = liveCnt;
+        }
+
+        /**
+         * @brief
+         *  Compacts the set identifiers once `SetCnt` reaches 
+         *  `-herbrand-compact-threshold` and twice the number of set
+         *  identifiers left by the last compaction.
+         *
+         * @details
+         *  The work of a compaction is thus paid for by the set 
+         *  identifiers created since the last one, and `Parent` and
+         *  `SetCnt` stay proportional to the set identifiers in the
+         *  partitions. `packKey` allows atmost 2^28 set identifiers.
+         *
+         * @returns     Void
+         *
+         * @see     compact, CompactThreshold
+         **/
+        void maybeCompact() {
+            if(CompactThreshold > 0 and 
+               SetCnt >= std::max<int>(CompactThreshold, 2 * LiveSetCnt))
+                compact();
+        }
+
+        /**
+         * @brief Checks whether two partitions are same.
+         * 
+         * @details
+         *  Two partitions are same if in the vectors representing
+         *  them values at two indexes are equal in the first 
+         *  vector iff they are equal in the second vector.
+         *  Both the vectors are relabelled on the fly to canonical 
+         *  form, where set identifiers are renumbered in the order 
+         *  of their first occurrence, and the partitions are same 
+         *  iff their canonical forms are equal. This takes a single
+         *  pass and does not allocate once `CanonicalLabel` has 
+         *  grown to `SetCnt` entries.
+         * 
+         * @param[in]   first   First partition
+         * @param[in]   second  Second partition
+         * @param[in]   worker  Worker whose scratch space is used,
+         *                      `nullptr` for that of the context
+         * @return      Returns true if the two partitions are same,
+         *              otherwise false
+         * 
+         * @see     CanonicalLabel, Indexer, Partitions
+         **/
+        bool samePartition(Partition const &first, Partition const &second,
+                           WorkerTy *worker = nullptr) {
+            // partitions sharing all their storage are equal
+            if(first.sameStorage(second)) return true;
+
+            // a TOP partition is only same as another TOP partition
+            bool firstTop = (first[0] == -1), secondTop = (second[0] == -1);
+            if(firstTop or secondTop) return firstTop == secondTop;
+
+            std::vector<std::pair<int, int>> *canonicalLabel = CanonicalLabel;
+            int *canonicalStamp = &CanonicalStamp, setCnt = SetCnt;
+            if(worker) {
+                canonicalLabel = worker->CanonicalLabel;
+                canonicalStamp = &worker->CanonicalStamp, setCnt = worker->SetCnt;
+            }
+
+            for(int k = 0; k < 2; k++)
+                if((int)canonicalLabel[k].size() < setCnt) 
+                    canonicalLabel[k].resize(setCnt, {0, 0});
+            int stamp = ++*canonicalStamp;
+
+            // next canonical label to be given in each partition
+            int nextLabel[2] = {0, 0};
+
+            for(int i = 0; i < (int)first.size(); i++) {
+                int setId[2] = {first[i], second[i]};
+
+                for(int k = 0; k < 2; k++) {
+                    std::pair<int, int> &label = canonicalLabel[k][setId[k]];
+                    if(label.first != stamp)
+                        label = {stamp, nextLabel[k]++};
+                }
+
+                if(canonicalLabel[0][setId[0]].second != 
+                   canonicalLabel[1][setId[1]].second)
+                    return false;
+            }
+
+            // the partitions are equivalent, so return `true`
+            return true;
+        }
+
+        /**
+         * @brief 
+         *  Returns set identifier for a given two length expression 
+         *  at a program point.
+         * 
+         * @details
+         *  With the help of `Parent` map, first a check is made if 
+         *  a set identifier representing the expression at the
+         *  current program point exists. If so it is returned else
+         *  a new set identifier is created by updating `SetCnt` and
+         *  returned. This information is also stored in the 
+         *  `Parent` map for future use.
+         * 
+         * @param[in]   partition   Vector representing the partition 
+         *                          at the program point.
+         * @param[in]   expIdx      Index of the expression whose set
+         *                          identifier is required at the
+         *                          program point.
+         * @param[in]   worker      Worker solving the program point in
+         *                          wavefront mode, otherwise `nullptr`.
+         * @return      The set identifier for the expression at the 
+         *              program point.
+         * 
+         * @note    Make sure that the second argument passed represents a 
+         *          length two expression.
+         * 
+         * @see     Indexer, Parent, Partitions, SetCnt, WorkerTy
+         **/
+        int findSet(Partition const &partition, int expIdx, WorkerTy *worker = nullptr) {
+            // operator and set identifiers corresponding to left and right 
+            // subexpressions at the current program point 
+            char op = Indexer.op(expIdx);
+            int leftSetId = partition[Indexer.leftIndex(expIdx)];
+            int rightSetId = partition[Indexer.rightIndex(expIdx)];
+
+            // if a set representing the expression already exists
+            // return its identifier, otherwise return new set 
+            // identifier and update `Parent` map with this information
+            uint64_t key = packKey(op, leftSetId, rightSetId);
+            if(not worker) {
+                std::pair<int, bool> ret = Parent.insert(key, SetCnt);
+                if(ret.second) SetCnt++;
+                HERBRAND_STAT(ret.second ? Stats.FindSetMisses++ : Stats.FindSetHits++);
+                return ret.first;
+            }
+
+            // a worker records the key for which it creates a set 
+            // identifier, see `commitWorker`
+            int setId = findParent(key, worker);
+            HERBRAND_STAT(setId == -1 ? worker->FindSetMisses++ : worker->FindSetHits++);
+            if(setId == -1) {
+                setId = allocSetId(worker);
+                worker->Origin.back() = key;
+                worker->Parent.assign(key, setId);
+            }
+            return setId;
+        }
+
+        /**
+         * @brief Finds initial partition.
+         * 
+         * @details
+         *  Finds a vector representing initial partition
+         *  in which all expressions are in different 
+         *  partition (has non-equivalent set identifiers).
+         *  It also updates `Parent` map for set identifiers
+         *  assigned to length two expressions.
+         * 
+         * @param[out]  partition   Vector to store the 
+         *                          initial partition.
+         * @return      Void
+         * 
+         * @see     findSet, Indexer, Partitions
+         **/
+        void findInitialPartition(Partition &partition) {
+            // create new IDstruct object for each epxression.
+            // For length two expressions this is done indirectly
+            // by calling `findSet` function which also updates
+            // `Parent` map
+            for(int i = 0; i < Indexer.size(); i++) {
+                if(Indexer.isValue(i)) partition.set(i, SetCnt++);
+                else partition.set(i, findSet(partition, i));
+            }
+        }
+
+        /**
+         * @brief
+         *  Returns equivalence class of an expression at a 
+         *  given program point.
+         * 
+         * @details
+         *  The equivalence class is the set of indexes corresponding
+         *  to expressions (as given by `Indexer`) which have same
+         *  set identifiers as the index representing the expression 
+         *  (passed as parameter) in the partition at the program point.
+         *  
+         *
+         * @param[in]   partition   Vector representing the partition
+         *                          at current program point.
+         * @param[in]   expIdx      Index of expression whose equivalence
+         *                          class is required.
+         * @param[out]  expClass    Set containing identifiers corresponding
+         *                          to the required equivalence class.
+         * @return      Void
+         * 
+         * @see     Indexer, Partitions
+         **/
+        void getClass(Partition const &partition, int expIdx, 
+                      std::set<int> &expClass) {
+
+            expClass.clear();
+            int expSetId = partition[expIdx];
+            HERBRAND_STAT(Stats.GetClassCalls++, Stats.GetClassScanned += Indexer.size());
+
+            for(int i = 0; i < Indexer.size(); i++) {
+                if(expSetId == partition[i])
+                    expClass.insert(i);
+            }
+        }
+
+        /**
+         * @brief Transfer function associated with Herbrand analysis.
+         * 
+         * @param[in,out]   partition   Partition before the instruction,
+         *                              which is modified to the partition
+         *                              after it.
+         * @param[in]       inst        Instruction on which the transfer
+         *                              function is applied.
+         * @param[in]       worker      Worker solving the instruction in
+         *                              wavefront mode, otherwise `nullptr`.
+         * @returns     Void
+         * 
+         * @see     findSet, Indexer, Partitions, transferBlock
+         **/
+        void transferFunction(Partition &partition, Instruction *inst, 
+                              WorkerTy *worker = nullptr) {
+            // if the current partition has any index with value -1, it 
+            // means that it represents the TOP element and it has to be
+            // left as such without any modifications
+            if(partition[0] == -1) return;
+
+            // `changedExp` is expression (ie. a variable) which
+            // has been assigned value and `changedToExp` is the 
+            // expression which has been assigned to it. If 
+            // operator in `changedToExp` is `#` - it symbolises
+            // non-deterministic assignment
+            ExpressionTy changedExp, changedToExp;
+
+            if(isa<LoadInst>(inst)) {
+                changedExp = EXP(inst);
+                changedToExp = EXP(inst->getOperand(0));
+            } else if(isa<StoreInst>(inst)) {
+                changedExp = EXP(inst->getOperand(1));
+                changedToExp = EXP(inst->getOperand(0));
+            } else if(isa<BinaryOperator>(inst)) {
+                char op = getOpSymbol(inst->getOpcodeName());
+                Value *leftOp = inst->getOperand(0);
+                Value *rightOp = inst->getOperand(1);
+                changedExp = EXP(inst);
+                changedToExp = {op, leftOp, rightOp};
+            } else if(isa<CallInst>(inst)) {
+                changedExp = EXP(inst);
+                // here `#` symbolises non-deterministic assignment
+                changedToExp = {'#', nullptr, nullptr};
+            } else {
+                // in this case the current instruction has not
+                // modified the partition, so the function returns
+                return;
+            }
+
+            // a store to memory which is not tracked (eg. a global)
+            // does not modify the partition
+            int changedIdx = Indexer.index(changedExp);
+            if(changedIdx == -1) return;
+
+            // an expression which is not tracked (eg. one using a
+            // function argument or an operator not in `Ops`) is
+            // treated like a non-deterministic assignment
+            int changedToIdx = -1;
+            if(std::get<0>(changedToExp) != '#')
+                changedToIdx = Indexer.index(changedToExp);
+
+            if(changedToIdx == -1) {
+                // if it is a non-deterministic assignment, 
+                // then create a new set identifier
+                partition.set(changedIdx, allocSetId(worker));
+            } else {
+                // assign the `changedExp`, the set identifier of 
+                // `changedToExp`
+                partition.set(changedIdx, partition[changedToIdx]);
+            }
+
+            // update set identifiers for two length expressions 
+            // involving `changedExp`, set identifiers of all other
+            // expressions remain the same
+            for(int el : UsedBy[changedIdx])
+                partition.set(el, findSet(partition, el, worker));
+        }
+
+        /**
+         * @brief
+         *  Updates `Parent` at a confluence point for the length two
+         *  expressions not tracked in sparse mode.
+         * 
+         * @details
+         *  Without sparse mode every length two expression `l op r`
+         *  gets a set identifier from the tuple of its set identifiers
+         *  across the predecessors, which is then recorded in `Parent`.
+         *  Here the same is done for each operator and each pair of 
+         *  classes of constants and variables, reading the tuple from
+         *  `Parent` (a key missing there stands for a class of its own).
+         *  A class is recorded only if it is not fresh, ie. if it is
+         *  same in all the predecessors, is the class of a tracked 
+         *  expression or is shared by more than one such pair. A fresh
+         *  class is left to `findSet` to create when needed.
+         * 
+         * @param[in]   partition       Partition at the confluence point,
+         *                              already computed for the tracked
+         *                              expressions.
+         * @param[in]   predPartitions  Partitions of the predecessors 
+         *                              which are not TOP.
+         * @param[in]   newSetId        Set identifiers given to the tuples
+         *                              of the tracked expressions.
+         * @param[in]   worker          Worker solving the confluence point
+         *                              in wavefront mode, otherwise 
+         *                              `nullptr`.
+         * @return      Hash describing the classes recorded, in terms of
+         *              the partition at the confluence point.
+         * 
+         * @see     confluenceFunction, ClosureSignature, SparseMode
+         **/
+        uint64_t confluenceClosure(Partition const &partition,
+                std::vector<Partition const *> const &predPartitions,
+                std::unordered_map<std::vector<int>, int, SetIdTupleHash> const &newSetId,
+                WorkerTy *worker) {
+            // a tuple element for a key missing in `Parent`, set 
+            // identifiers never have the highest bit set
+            const uint64_t missingBit = 1ULL << 63;
+
+            // classes by their tuples, starting with those of the tracked
+            // expressions. A class seen once so far has no set identifier
+            // and keeps the key and position of the pair which formed it.
+            // The tuples are stored one after another in `groupTuples` and
+            // looked up by their hash in `groupIndex`, probing the next
+            // hash on a collision
+            struct GroupTy { int setId; uint64_t firstKey; int firstPair; };
+            std::vector<GroupTy> groups;
+            std::vector<uint64_t> groupTuples;
+            FlatHashMap groupIndex;
+            int tupSize = predPartitions.size();
+
+            // returns the class of a tuple and whether it is new, adding
+            // `group` as its class if so
+            auto findGroup = [&](std::vector<uint64_t> const &tup, GroupTy group) {
+                uint64_t hash = SetIdTupleHash()(tup) & ~missingBit;
+                while(true) {
+                    std::pair<int, bool> ret = groupIndex.insert(hash, groups.size());
+                    if(ret.second) {
+                        groups.push_back(group);
+                        groupTuples.insert(groupTuples.end(), tup.begin(), tup.end());
+                        return ret;
+                    }
+
+                    auto it = groupTuples.begin() + (size_t)ret.first * tupSize;
+                    if(std::equal(tup.begin(), tup.end(), it)) return ret;
+                    hash = (hash + 1) & ~missingBit;
+                }
+            };
+
+            for(auto &el : newSetId) {
+                GroupTy group = {el.second, 0, -1};
+                findGroup(std::vector<uint64_t>(el.first.begin(), el.first.end()), group);
+            }
+
+            // canonical labels of set identifiers in order of their first
+            // occurrence, and a representative for each class of constants
+            // and variables
+            std::unordered_map<int, int> label;
+            auto getLabel = [&](int setId) {
+                return label.emplace(setId, (int)label.size()).first->second;
+            };
+
+            std::vector<int> reps;
+            for(int i = 0; i < Indexer.size(); i++) {
+                bool seen = label.count(partition[i]);
+                getLabel(partition[i]);
+                if(not seen and Indexer.isValue(i)) reps.push_back(i);
+            }
+
+            uint64_t signature = 0xcbf29ce484222325ULL;
+            auto mix = [&](int val) { 
+                signature = (signature ^ (uint32_t)val) * 0x100000001b3ULL; 
+            };
+
+            std::vector<uint64_t> tup(predPartitions.size());
+            int pairCtr = 0;
+
+            for(char op : Indexer.ops())
+                for(int left : reps)
+                    for(int right : reps) {
+                        bool same = true;
+                        for(int j = 0; j < (int)tup.size(); j++) {
+                            Partition const &pred = *predPartitions[j];
+                            uint64_t predKey = packKey(op, pred[left], pred[right]);
+                            int setId = findParent(predKey, worker);
+
+                            tup[j] = (setId == -1 ? predKey | missingBit : setId);
+                            same &= (tup[j] == tup[0]);
+                        }
+
+                        uint64_t key = packKey(op, partition[left], partition[right]);
+                        int setId = -1;
+
+                        if(same and not (tup[0] & missingBit)) setId = tup[0];
+                        else {
+                            GroupTy newGroup = {-1, key, pairCtr};
+                            std::pair<int, bool> ret = findGroup(tup, newGroup);
+                            if(not ret.second) {
+                                GroupTy &group = groups[ret.first];
+                                if(group.setId == -1) {
+                                    // second pair of a class, which now needs
+                                    // a set identifier for both the pairs
+                                    group.setId = allocSetId(worker);
+                                    assignParent(group.firstKey, group.setId, worker);
+                                    mix(-2), mix(group.firstPair);
+                                }
+                                setId = group.setId;
+                            }
+                        }
+
+                        if(setId != -1) assignParent(key, setId, worker), mix(getLabel(setId));
+                        else mix(-1);
+                        pairCtr++;
+                    }
+
+            return signature;
+        }
+
+        /**
+         * @brief Confluence function associated with Herbrand analysis.
+         * 
+         * @param[in]   blockIndex  Basic block graph node index at whose
+         *                          entry confluence function is applied.
+         *                          The function modifies 
+         *                          `EntryPartitions[blockIndex]`.
+         * @param[in]   worker      Worker solving the node in wavefront
+         *                          mode, otherwise `nullptr`.
+         * @returns     Void
+         * 
+         * @see     findSet, Indexer, EntryPartitions, Partitions
+         **/
+        void confluenceFunction(int blockIndex, WorkerTy *worker = nullptr) {
+            // vector of  predecessor node indexes
+            std::vector<int> &predecessors = Blocks[blockIndex].predecessors;
+        
+            // if all the predecessors partition represents TOP 
+            // element then their confluence is also TOP element.
+            // So, the current partition need not be modified as
+            // by initialisation the current partition should also
+            // hold TOP partition
+            bool cont = false;
+            for(int pred : predecessors)
+                cont |= (Partitions[pred][0] != -1);
+            if(not cont) return;
+
+            // the current partition
+            Partition &partition = EntryPartitions[blockIndex];
+
+            // predecessors whose partitions are not TOP, the TOP
+            // partitions do not affect the confluence
+            std::vector<Partition const *> predPartitions;
+            for(int pred : predecessors)
+                if(Partitions[pred][0] != -1)
+                    predPartitions.push_back(&Partitions[pred]);
+
+            // two expressions are equivalent at the confluence point iff
+            // they are equivalent in all the predecessors, ie. iff they 
+            // have the same tuple of set identifiers across the
+            // predecessors. `newSetId` maps each such tuple to the set 
+            // identifier assigned to it
+            std::unordered_map<std::vector<int>, int, SetIdTupleHash> newSetId;
+            std::vector<int> tup(predPartitions.size());
+
+            // process all the expressions one by one. If the set 
+            // identifier for the expression in all the predecessors 
+            // is same it is assigned the same set identifier; else
+            // the set identifier for its tuple is assigned, creating
+            // a new one if this tuple is seen for the first time
+            for(int i = 0; i < Indexer.size(); i++) {
+                // a leaf shared by all the predecessors holds the same set
+                // identifiers in all of them, so it is shared as a whole
+                if(i % Partition::LeafSize == 0) {
+                    bool shared = true;
+                    for(Partition const *pred : predPartitions)
+                        shared &= pred->sameLeaf(*predPartitions[0], i);
+
+                    if(shared) {
+                        partition.shareLeaf(*predPartitions[0], i);
+                        i += Partition::LeafSize - 1;
+                        continue;
+                    }
+                }
+
+                bool same = true;
+                for(int j = 0; j < (int)tup.size(); j++) {
+                    tup[j] = (*predPartitions[j])[i];
+                    same &= (tup[j] == tup[0]);
+                }
+
+                if(same) {
+                    partition.set(i, tup[0]);
+                    continue;
+                }
+
+                auto it = newSetId.find(tup);
+                if(it == newSetId.end()) it = newSetId.emplace(tup, allocSetId(worker)).first;
+                partition.set(i, it->second);
+            }
+
+            // now update `Parent` map
+            for(int i = Indexer.numValues(); i < Indexer.size(); i++) {
+                int leftSetID = partition[Indexer.leftIndex(i)];
+                int rightSetID = partition[Indexer.rightIndex(i)];
+
+                uint64_t key = packKey(Indexer.op(i), leftSetID, rightSetID);
+                // this assertion must be passed for the consistency of the algorithm
+                assert(findParent(key, worker) == -1 or 
+                       findParent(key, worker) == partition[i]);
+
+                assignParent(key, partition[i], worker);
+            }
+
+            // and the untracked expressions in sparse mode
+            if(SparseMode) 
+                ClosureSignature[blockIndex] = confluenceClosure(partition, predPartitions, 
+                                                                 newSetId, worker);
+        }
+
+        /**
+         * @brief Returns the partition at the entry of a basic block graph node.
+         *
+         * @param[in]   blockIndex  Basic block graph node index
+         * @returns     The entry partition, which is the exit partition
+         *              of its predecessor if it has only one
+         *
+         * @see     EntryPartitions, Partitions
+         **/
+        Partition const &entryPartition(int blockIndex) {
+            std::vector<int> &predecessors = Blocks[blockIndex].predecessors;
+            if(predecessors.size() > 1) return EntryPartitions[blockIndex];
+            return Partitions[predecessors[0]];
+        }
+
+        /**
+         * @brief
+         *  Applies the transfer functions of all the instructions of
+         *  a basic block one after another.
+         *
+         * @param[in]   blockIndex  Basic block graph node index. The 
+         *                          function modifies `Partitions[blockIndex]`.
+         * @param[in]   worker      Worker solving the node in wavefront
+         *                          mode, otherwise `nullptr`.
+         * @returns     Number of transfer functions applied
+         *
+         * @see     entryPartition, transferFunction
+         **/
+        int transferBlock(int blockIndex, WorkerTy *worker = nullptr) {
+            Partition &partition = Partitions[blockIndex];
+            partition = entryPartition(blockIndex);
+
+            BasicBlock *bb = Blocks[blockIndex].bbPtr;
+            if(bb == nullptr) return 0;
+
+            for(Instruction &I : *bb) transferFunction(partition, &I, worker);
+            return bb->size();
+        }
+
+        /**
+         * @brief Finds the partition at a program point.
+         *
+         * @details
+         *  Partitions are kept only at the entry and exit of basic 
+         *  blocks, so for a program point inside a basic block the 
+         *  instructions before it are applied again on the partition
+         *  at the entry of the block. This should be called only after
+         *  the analysis has converged.
+         *
+         * @param[in]   cfgIndex    Control flow graph node index
+         * @param[out]  partition   Partition at (after) the node
+         * @returns     Void
+         *
+         * @see     entryPartition, Partitions, transferFunction
+         **/
+        void partitionAt(int cfgIndex, Partition &partition) {
+            CfgNodeTy &node = CFG[cfgIndex];
+
+            if(node.NodeTy == CfgNodeTy::START) partition = Partitions[0];
+            else if(node.NodeTy == CfgNodeTy::END) partition = Partitions.back();
+            else if(node.NodeTy == CfgNodeTy::CONFLUENCE) {
+                // the confluence point is the entry of the block of its 
+                // successor
+                int blockIndex = BlockIndex[CFG[node.successors[0]].instPtr->getParent()];
+                partition = EntryPartitions[blockIndex];
+            } else {
+                int blockIndex = BlockIndex[node.instPtr->getParent()];
+                partition = entryPartition(blockIndex);
+
+                for(Instruction &I : *node.instPtr->getParent()) {
+                    transferFunction(partition, &I);
+                    if(&I == node.instPtr) break;
+                }
+            }
+        }
+
+        /**
+         * @brief
+         *  Finds the order in which basic block graph nodes are
+         *  taken out of the worklist of their strongly connected
+         *  component.
+         *
+         * @details
+         *  Each node gets a priority key `{-loopDepth, rpoNumber}`,
+         *  where `rpoNumber` is its position in the reverse postorder
+         *  of a depth first search from START and `loopDepth` is the
+         *  number of natural loops containing it. Smaller keys are
+         *  processed first, so inner loops converge before outer ones
+         *  and within a loop nest nodes are visited in reverse
+         *  postorder.
+         *
+         * @param[out]  priority    Priority key of each node
+         * @returns     Void
+         *
+         * @see     Blocks, HerbrandAnalysis
+         **/
+        void findWorklistOrder(std::vector<std::pair<int, int>> &priority) {
+            int cfgSize = Blocks.size();
+
+            // iterative depth first search from START. `onStack` marks
+            // the nodes on the current DFS path, an edge into such a
+            // node is a back edge
+            std::vector<int> postorder, nextSucc(cfgSize, 0);
+            std::vector<bool> visited(cfgSize, false), onStack(cfgSize, false);
+            std::vector<std::pair<int, int>> backEdges;
+            std::vector<int> stk({0});
+            visited[0] = onStack[0] = true;
+
+            while(not stk.empty()) {
+                int cur = stk.back();
+                std::vector<int> &succs = Blocks[cur].successors;
+
+                if(nextSucc[cur] == (int)succs.size()) {
+                    onStack[cur] = false;
+                    postorder.push_back(cur), stk.pop_back();
+                    continue;
+                }
+
+                int succ = succs[nextSucc[cur]++];
+                if(onStack[succ]) backEdges.push_back({cur, succ});
+                else if(not visited[succ]) {
+                    visited[succ] = onStack[succ] = true;
+                    stk.push_back(succ);
+                }
+            }
+
+            // collect the natural loop of each back edge `latch -> header`
+            // by walking predecessors from the latch until the header. Back
+            // edges to the same header form a single loop
+            std::map<int, std::set<int>> loops;
+            for(auto &edge : backEdges) {
+                std::set<int> &body = loops[edge.second];
+                body.insert(edge.second);
+
+                std::vector<int> work;
+                if(body.insert(edge.first).second) work.push_back(edge.first);
+                while(not work.empty()) {
+                    int cur = work.back();
+                    work.pop_back();
+                    for(int pred : Blocks[cur].predecessors)
+                        if(body.insert(pred).second) work.push_back(pred);
+                }
+            }
+
+            std::vector<int> loopDepth(cfgSize, 0);
+            for(auto &loop : loops)
+                for(int el : loop.second) loopDepth[el]++;
+
+            priority.assign(cfgSize, {0, 0});
+            for(int i = 0; i < cfgSize; i++) {
+                int node = postorder[cfgSize - 1 - i];
+                priority[node] = {-loopDepth[node], i};
+            }
+        }
+
+        /**
+         * @brief
+         *  Processes a basic block graph node and returns whether its
+         *  successors need to be processed again.
+         *
+         * @details
+         *  Processing a node applies the confluence function at its
+         *  entry, if it has more than one predecessor, and then the 
+         *  transfer functions of its instructions. Successors need to
+         *  be processed again only if the partition at the exit of the
+         *  node has changed. In sparse mode a change in the untracked
+         *  expressions is seen only at confluence points, so a node
+         *  without one always passes on the change which caused it to
+         *  be processed.
+         *
+         * @param[in]   blockIndex  Basic block graph node index
+         * @param[out]  counters    Counters updated for the node
+         * @param[in]   worker      Worker solving the node in wavefront
+         *                          mode, otherwise `nullptr`
+         * @returns     True if the successors are to be processed again
+         *              otherwise false
+         *
+         * @see     confluenceFunction, samePartition, transferBlock
+         **/
+        bool processNode(int blockIndex, CountersTy &counters, WorkerTy *worker = nullptr) {
+            counters.Iterations++;
+
+            // partitions at the exit and entry of the node before
+            // processing it, sharing their storage
+            Partition oldPartition = Partitions[blockIndex];
+
+            bool isConfluence = (Blocks[blockIndex].predecessors.size() > 1);
+            bool entryChanged = false;
+            if(isConfluence) {
+                Partition oldEntryPartition = EntryPartitions[blockIndex];
+                uint64_t oldSignature = ClosureSignature[blockIndex];
+
+                confluenceFunction(blockIndex, worker), counters.Confluences++;
+                entryChanged = not samePartition(oldEntryPartition, EntryPartitions[blockIndex],
+                                                 worker) or
+                               ClosureSignature[blockIndex] != oldSignature;
+            }
+            int transfers = transferBlock(blockIndex, worker);
+            counters.Transfers += transfers;
+
+            bool changed = not samePartition(oldPartition, Partitions[blockIndex], worker);
+            if(SparseMode) changed |= (isConfluence ? entryChanged : true);
+
+            // a worker's set identifiers are provisional, so `SetCnt` 
+            // is sampled once they are committed
+            HERBRAND_STAT(Stats.NodeTransfers[blockIndex] += transfers,
+                          Stats.NodeConfluences[blockIndex] += isConfluence);
+            HERBRAND_STAT(if(not worker) Stats.sampleSetCnt(counters.Iterations, SetCnt));
+            return changed;
+        }
+
+        /**
+         * @brief
+         *  Finds the strongly connected components of the basic block
+         *  graph.
+         *
+         * @details
+         *  Uses an iterative version of Tarjan's algorithm, which finds
+         *  a component only after all the components reachable from it,
+         *  so the components are reversed at the end.
+         *
+         * @param[out]  components  Nodes of each component, the components
+         *                          in topological order
+         * @param[out]  componentOf Component of each node
+         * @returns     Void
+         *
+         * @see     Blocks, solveWavefront
+         **/
+        void findComponents(std::vector<std::vector<int>> &components,
+                            std::vector<int> &componentOf) {
+            int blockCnt = Blocks.size();
+            std::vector<int> order(blockCnt, -1), low(blockCnt, 0), nextSucc(blockCnt, 0);
+            std::vector<bool> onStack(blockCnt, false);
+            std::vector<int> nodeStack, dfsStack;
+            int orderCtr = 0;
+
+            components.clear();
+            componentOf.assign(blockCnt, -1);
+
+            for(int root = 0; root < blockCnt; root++) {
+                if(order[root] != -1) continue;
+
+                dfsStack.push_back(root);
+                while(not dfsStack.empty()) {
+                    int cur = dfsStack.back();
+                    if(nextSucc[cur] == 0 and order[cur] == -1) {
+                        order[cur] = low[cur] = orderCtr++;
+                        nodeStack.push_back(cur), onStack[cur] = true;
+                    }
+
+                    std::vector<int> &succs = Blocks[cur].successors;
+                    if(nextSucc[cur] < (int)succs.size()) {
+                        int succ = succs[nextSucc[cur]++];
+                        if(order[succ] == -1) dfsStack.push_back(succ);
+                        else if(onStack[succ]) low[cur] = std::min(low[cur], order[succ]);
+                        continue;
+                    }
+
+                    // all the successors are done, `cur` is the root of a 
+                    // component iff no node on the stack above it reaches
+                    // a node below it
+                    dfsStack.pop_back();
+                    if(not dfsStack.empty())
+                        low[dfsStack.back()] = std::min(low[dfsStack.back()], low[cur]);
+                    if(low[cur] != order[cur]) continue;
+
+                    components.emplace_back();
+                    while(true) {
+                        int node = nodeStack.back();
+                        nodeStack.pop_back(), onStack[node] = false;
+                        components.back().push_back(node);
+                        if(node == cur) break;
+                    }
+                }
+            }
+
+            std::reverse(components.begin(), components.end());
+            for(int c = 0; c < (int)components.size(); c++)
+                for(int node : components[c]) componentOf[node] = c;
+        }
+
+        /**
+         * @brief
+         *  Finds the strongly connected components of the basic block
+         *  graph in topological order, with the nodes of each component
+         *  in the order of their priority.
+         *
+         * @param[in]   priority    Priority key of each node
+         * @param[out]  components  Nodes of each component
+         * @param[out]  componentOf Component of each node
+         * @param[out]  localIndex  Position of each node in the nodes of
+         *                          its component
+         * @returns     Void
+         *
+         * @see     findComponents, findWorklistOrder
+         **/
+        void orderComponents(std::vector<std::pair<int, int>> const &priority,
+                             std::vector<std::vector<int>> &components,
+                             std::vector<int> &componentOf, std::vector<int> &localIndex) {
+            findComponents(components, componentOf);
+
+            localIndex.assign(Blocks.size(), 0);
+            for(auto &nodes : components) {
+                std::sort(nodes.begin(), nodes.end(),
+                          [&](int a, int b) { return priority[a] < priority[b]; });
+                for(int i = 0; i < (int)nodes.size(); i++)
+                    localIndex[nodes[i]] = i;
+            }
+        }
+
+        /**
+         * @brief
+         *  Computes the fixpoint of a strongly connected component with
+         *  a worklist local to it, once the components before it are
+         *  solved.
+         *
+         * @details
+         *  Initially the nodes of the component with a predecessor in an
+         *  earlier component are in the worklist, so a node outside any
+         *  loop is processed exactly once. Only the successors in the 
+         *  same component are added to the worklist, and they are taken
+         *  out in the order of their priority, so an inner loop is 
+         *  iterated until it is stable before the rest of its outer loop
+         *  is processed again.
+         *
+         * @param[in]   nodes       Nodes of the component, in the order
+         *                          of their priority
+         * @param[in]   componentOf Component of each node
+         * @param[in]   localIndex  Position of each node in the nodes of
+         *                          its component
+         * @param[out]  counters    Counters updated for the nodes
+         * @param[in]   worker      Worker solving the component in
+         *                          wavefront mode, otherwise `nullptr`
+         * @param[in]   verbosity   Amount of output printed for the nodes
+         *                          as they are processed, only without a
+         *                          worker. Without a worker the set 
+         *                          identifiers are also compacted when
+         *                          needed
+         * @returns     Void
+         *
+         * @see     processNode, solveComponents, solveWavefront
+         **/
+        void solveComponent(std::vector<int> const &nodes, std::vector<int> const &componentOf,
+                            std::vector<int> const &localIndex, CountersTy &counters,
+                            WorkerTy *worker, VerbosityTy verbosity) {
+            std::set<int> worklist;
+            for(int i = 0; i < (int)nodes.size(); i++)
+                for(int pred : Blocks[nodes[i]].predecessors)
+                    if(componentOf[pred] != componentOf[nodes[i]]) {
+                        worklist.insert(i);
+                        break;
+                    }
+
+            while(not worklist.empty()) {
+                int node = nodes[*worklist.begin()];
+                worklist.erase(worklist.begin());
+
+                bool changed = processNode(node, counters, worker);
+                if(not worker) {
+                    if(verbosity == TRACE) printBlock(node);
+                    else if(verbosity == SUMMARY) printSummary(node, changed);
+                    maybeCompact();
+                }
+
+                if(not changed) continue;
+                for(int succ : Blocks[node].successors)
+                    if(componentOf[succ] == componentOf[node])
+                        worklist.insert(localIndex[succ]);
+            }
+        }
+
+        /**
+         * @brief
+         *  Computes the fixpoint by solving the strongly connected
+         *  components of the basic block graph one after another, in
+         *  topological order.
+         *
+         * @details
+         *  All the predecessors of a component outside it are in earlier
+         *  components, so their partitions are final once the component
+         *  is reached. A node outside any loop is thus processed exactly
+         *  once, and a loop is iterated only until it is stable, without
+         *  processing the nodes after it again.
+         *
+         * @param[in]   priority    Priority key of each node
+         * @param[out]  counters    Counters updated for the nodes
+         * @param[in]   verbosity   Amount of output printed for the nodes
+         *                          as they are processed
+         * @param[in]   affected    Nodes to be solved, all the nodes if it
+         *                          is `nullptr`. The other nodes must hold
+         *                          their partitions on convergence already,
+         *                          and a component is either solved 
+         *                          completely or not at all
+         * @returns     Void
+         *
+         * @see     orderComponents, solveComponent, updateInstruction
+         **/
+        void solveComponents(std::vector<std::pair<int, int>> const &priority,
+                             CountersTy &counters, VerbosityTy verbosity,
+                             std::vector<bool> const *affected = nullptr) {
+            std::vector<std::vector<int>> components;
+            std::vector<int> componentOf, localIndex;
+            orderComponents(priority, components, componentOf, localIndex);
+
+            for(auto &nodes : components) {
+                // START is solved already
+                if(nodes[0] == 0 or (affected and not (*affected)[nodes[0]])) continue;
+                solveComponent(nodes, componentOf, localIndex, counters, nullptr, verbosity);
+            }
+        }
+
+        /**
+         * @brief
+         *  Replaces the provisional set identifiers of a worker by set
+         *  identifiers of the context, and commits its `Parent` entries.
+         *
+         * @details
+         *  Provisional set identifiers get new set identifiers in the
+         *  order they were created, except that one created by `findSet`
+         *  for a key which is now in `Parent`, committed by an earlier
+         *  worker of the same wavefront, takes the set identifier there
+         *  as it would have if the components were solved one after
+         *  another. The partitions of the component and the entries of
+         *  the map of the worker are then rewritten. This depends only
+         *  on the worker and the order of the commits, not on the order
+         *  in which the workers ran.
+         *
+         * @param[in,out]   worker  Worker whose wavefront is solved
+         * @returns     Void
+         *
+         * @see     solveWavefront, WorkerTy
+         **/
+        void commitWorker(WorkerTy &worker) {
+            std::vector<int> newId(worker.SetCnt - worker.Base);
+            auto translate = [&](int setId) {
+                return setId < worker.Base ? setId : newId[setId - worker.Base];
+            };
+            auto translateKey = [&](uint64_t key) {
+                return packKey(keyOp(key), translate(keyLeft(key)), translate(keyRight(key)));
+            };
+
+            // the operands of a key are created before the set identifier
+            // created for it, so they are translated already
+            for(int i = 0; i < (int)newId.size(); i++) {
+                int setId = -1;
+                if(worker.Origin[i] != ~0ULL) setId = Parent.find(translateKey(worker.Origin[i]));
+                newId[i] = (setId != -1 ? setId : SetCnt++);
+            }
+
+            worker.Parent.forEach([&](uint64_t key, int setId) {
+                Parent.assign(translateKey(key), translate(setId));
+            });
+
+            auto translatePartition = [&](Partition &partition) {
+                if(partition.size() == 0 or partition[0] == -1) return;
+                for(int i = 0; i < partition.size(); i++)
+                    if(partition[i] >= worker.Base) partition.set(i, translate(partition[i]));
+            };
+            for(int node : worker.Nodes) {
+                translatePartition(Partitions[node]);
+                translatePartition(EntryPartitions[node]);
+            }
+        }
+
+        /**
+         * @brief
+         *  Computes the fixpoint by wavefronts of the strongly connected
+         *  components of the basic block graph.
+         *
+         * @details
+         *  The wavefront of a component is one more than the largest 
+         *  wavefront of the components with an edge into it, so there is
+         *  no path between two components of the same wavefront. All the
+         *  components of a wavefront are solved at the same time on 
+         *  `NumThreads` threads, each by its own worker, and then the
+         *  workers are committed in the topological order of their 
+         *  components. The result does not depend on the number of
+         *  threads.
+         *
+         * @param[in]   priority    Priority key of each node
+         * @param[out]  counters    Counters updated for the nodes
+         * @param[in]   verbosity   Amount of output printed for the nodes
+         *                          as their workers are committed
+         * @returns     Void
+         *
+         * @see     commitWorker, findComponents, solveComponent
+         **/
+        void solveWavefront(std::vector<std::pair<int, int>> const &priority,
+                            CountersTy &counters, VerbosityTy verbosity) {
+            std::vector<std::vector<int>> components;
+            std::vector<int> componentOf, localIndex;
+            orderComponents(priority, components, componentOf, localIndex);
+
+            std::vector<int> wavefront(components.size(), 0);
+            std::vector<std::vector<int>> wavefronts;
+            for(int c = 0; c < (int)components.size(); c++) {
+                std::vector<int> &nodes = components[c];
+                for(int node : nodes)
+                    for(int pred : Blocks[node].predecessors)
+                        if(componentOf[pred] != c)
+                            wavefront[c] = std::max(wavefront[c], wavefront[componentOf[pred]] + 1);
+
+                // START is solved already
+                if(nodes[0] == 0) continue;
+                if((int)wavefronts.size() <= wavefront[c]) wavefronts.resize(wavefront[c] + 1);
+                wavefronts[wavefront[c]].push_back(c);
+            }
+
+            std::unique_ptr<ThreadPool> pool;
+            if(NumThreads > 1) pool.reset(new ThreadPool(NumThreads));
+
+            for(auto &wave : wavefronts) {
+                std::vector<WorkerTy> workers(wave.size());
+                for(int k = 0; k < (int)wave.size(); k++) {
+                    workers[k].Nodes = components[wave[k]];
+                    workers[k].Base = workers[k].SetCnt = SetCnt;
+                }
+
+                for(auto &worker : workers) {
+                    WorkerTy *w = &worker;
+                    if(pool) pool->submit([this, w, &componentOf, &localIndex] {
+                        solveComponent(w->Nodes, componentOf, localIndex, w->Counters, w, FINAL);
+                    });
+                    else solveComponent(worker.Nodes, componentOf, localIndex, worker.Counters, 
+                                        &worker, FINAL);
+                }
+                if(pool) pool->wait();
+
+                for(auto &worker : workers) {
+                    commitWorker(worker);
+                    counters.Iterations += worker.Counters.Iterations;
+                    counters.Transfers += worker.Counters.Transfers;
+                    counters.Confluences += worker.Counters.Confluences;
+                    HERBRAND_STAT(Stats.FindSetHits += worker.FindSetHits,
+                                  Stats.FindSetMisses += worker.FindSetMisses,
+                                  Stats.sampleSetCnt(counters.Iterations, SetCnt));
+
+                    if(verbosity == TRACE) {
+                        for(int node : worker.Nodes) printBlock(node);
+                    } else if(verbosity == SUMMARY) {
+                        errs() << "Component of [" << worker.Nodes[0] << "] : "
+                               << worker.Nodes.size() << " nodes, "
+                               << worker.Counters.Iterations << " iterations\n";
+                    }
+                }
+                maybeCompact();
+            }
+        }
+
+        /**
+         * @brief
+         *  Returns whether the confluence function has to be
+         *  applied at a CFG node.
+         *
+         * @param[in]   cfgIndex    Control flow graph node index
+         * @returns     True for confluence points and for END
+         *              nodes with more than one predecessor
+         *
+         * @see     CFG, CfgNodeTy
+         **/
+        bool isConfluenceNode(int cfgIndex) {
+            if(CFG[cfgIndex].NodeTy == CfgNodeTy::CONFLUENCE) return true;
+            return CFG[cfgIndex].NodeTy == CfgNodeTy::END and
+                   CFG[cfgIndex].predecessors.size() > 1;
+        }
+
+        /**
+         * @brief Prints a CFG node along with its partition.
+         *
+         * @param[in]   cfgIndex    Control flow graph node index
+         * @param[in]   partition   Partition at the node
+         * @returns     Void
+         *
+         * @see     CFG, partitionAt, printPartition
+         **/
+        void printNode(int cfgIndex, Partition const &partition) {
+            std::vector<int> &predecessors = CFG[cfgIndex].predecessors;
+            Instruction *inst = CFG[cfgIndex].instPtr;
+
+            errs() << '[' << cfgIndex << "] : ";
+
+            if(isConfluenceNode(cfgIndex)) {
+                if(CFG[cfgIndex].NodeTy == CfgNodeTy::CONFLUENCE)
+                    errs() << "Confluence Point => ";
+                else errs() << "END => ";
+
+                errs() << "[Predecessors :";
+                for(auto el : predecessors) {
+                    errs() << ' ' << el << '('
+                           << CFG[el].instPtr->getParent()->getName()
+                           << ')';
+                }
+                errs() << "]\n\t";
+            } else {
+                if(CFG[cfgIndex].NodeTy == CfgNodeTy::TRANSFER) {
+                    errs() << "Transfer Point => ["
+                           << inst->getParent()->getName() << "] "
+                           << (*inst) << ' ';
+                } else errs() << "END => ";
+
+                errs() << "[Predecessors : " << predecessors[0] << "]\n\t";
+            }
+
+            printPartition(partition, Indexer);
+            errs() << "\n\n";
+        }
+
+        /**
+         * @brief 
+         *  Prints a basic block graph node along with the partition
+         *  at its exit.
+         *
+         * @param[in]   blockIndex  Basic block graph node index
+         * @returns     Void
+         *
+         * @see     Blocks, printPartition
+         **/
+        void printBlock(int blockIndex) {
+            BlockNodeTy &node = Blocks[blockIndex];
+            errs() << '[' << blockIndex << "] : ";
+
+            if(node.NodeTy == BlockNodeTy::END) errs() << "END => ";
+            else errs() << "Block => [" << node.bbPtr->getName() << "] ";
+
+            errs() << "[Predecessors :";
+            for(auto el : node.predecessors) errs() << ' ' << el;
+            errs() << "]\n\t";
+
+            printPartition(Partitions[blockIndex], Indexer);
+            errs() << "\n\n";
+        }
+
+        /**
+         * @brief
+         *  Prints a line for a basic block graph node processed, at
+         *  `SUMMARY` verbosity.
+         *
+         * @param[in]   blockIndex  Basic block graph node index
+         * @param[in]   changed     Whether its successors are to be
+         *                          processed again
+         * @returns     Void
+         **/
+        void printSummary(int blockIndex, bool changed) {
+            errs() << '[' << blockIndex << "] " << (changed ? "changed" : "unchanged") << '\n';
+        }
+
+        /**
+         * @brief
+         *  Computes the fixpoint from the initial partition, printing
+         *  the iterations as per `verbosity`.
+         *
+         * @details
+         *  The fixpoint is computed by solving the strongly connected
+         *  components of the basic block graph in topological order,
+         *  or by wavefronts of them if `-herbrand-wavefront` is given.
+         *  Within a component nodes are processed in the order given 
+         *  by `findWorklistOrder`. Any set identifiers and `Parent` 
+         *  entries of an earlier fixpoint are dropped first.
+         *
+         * @param[in]   verbosity   Amount of output
+         * @returns     Void
+         *
+         * @see     Counters, findWorklistOrder, solveComponents, 
+         *          solveWavefront
+         **/
+        void computeFixpoint(VerbosityTy verbosity) {
+            HERBRAND_TIMER(timer, Stats, "fixpoint");
+            HERBRAND_STAT(Stats.startFixpoint(Blocks.size()));
+            Parent.clear();
+            SetCnt = LiveSetCnt = 0;
+
+            // initialise partition vector with -1 for each program
+            // points and each expression - this stands for TOP 
+            // partition at each program point. Note that any element
+            // of partition vector being -1 means that whole vector
+            // holds -1 and represents TOP partition
+            int blockCnt = Blocks.size();
+            Partitions.assign(blockCnt, Partition(Indexer.size(), -1));
+            EntryPartitions.assign(blockCnt, Partition());
+            for(int i = 0; i < blockCnt; i++)
+                if(Blocks[i].predecessors.size() > 1)
+                    EntryPartitions[i].assign(Indexer.size(), -1);
+            ClosureSignature.assign(blockCnt, 0);
+
+            // initialise starting partition for START node
+            findInitialPartition(Partitions[0]);
+
+            if(verbosity != FINAL) {
+                PRINT_HEADER("Initial Partition");
+                printPartition(Partitions[0], Indexer);
+                errs() << "\n\n\n";
+
+                PRINT_HEADER("Iterations");
+            }
+
+            // priority of each node in the worklist of its component
+            std::vector<std::pair<int, int>> priority;
+            findWorklistOrder(priority);
+
+            Counters = CountersTy();
+            if(WavefrontMode) solveWavefront(priority, Counters, verbosity);
+            else solveComponents(priority, Counters, verbosity);
+        }
+
+        /**
+         * @brief
+         *  Computes the fixpoint again after the operands of an 
+         *  instruction of the function have been changed in place.
+         *
+         * @details
+         *  The basic blocks of the function and their instructions
+         *  must be the same as when the fixpoint was computed, only
+         *  the operands of `I` may differ. Only the partitions at the
+         *  basic blocks reachable from the block of `I` depend on it,
+         *  so the other blocks keep their partitions, and the blocks
+         *  reachable from it are set to TOP and solved again component
+         *  by component. `Counters` then counts only these blocks.
+         *  `Parent` is kept, as its entries hold at every program point.
+         *
+         *  If `I` uses a constant new to the function, or in sparse mode
+         *  is a length two expression which is not tracked, the 
+         *  expressions are indexed again and the fixpoint is computed
+         *  from the initial partition.
+         *
+         * @param[in]   F   Function being analysed
+         * @param[in]   I   Instruction whose operands have changed
+         * @returns     True if only the blocks reachable from the block
+         *              of `I` were solved, false if the whole function was
+         *
+         * @see     computeFixpoint, solveComponents
+         **/
+        bool updateInstruction(Function &F, Instruction *I) {
+            bool reindex = false;
+            if(not isa<AllocaInst>(I))
+                for(int i = 0; i < (int)I->getNumOperands(); i++)
+                    if(isa<ConstantInt>(I->getOperand(i)) and Constants.getInt(I->getOperand(i)) == -1)
+                        reindex = true;
+
+            if(SparseMode and isa<BinaryOperator>(I)) {
+                ExpressionTy exp(getOpSymbol(I->getOpcodeName()), 
+                                 I->getOperand(0), I->getOperand(1));
+                reindex |= (Ops.count(std::get<0>(exp)) and Indexer.index(exp) == -1 and
+                            Indexer.valueIndex(std::get<1>(exp)) != -1 and
+                            Indexer.valueIndex(std::get<2>(exp)) != -1);
+            }
+
+            if(reindex) {
+                Constants.clear(), Variables.clear();
+                assignIndex(F);
+                computeFixpoint(FINAL);
+                return false;
+            }
+
+            // blocks reachable from the block of `I`, an unreachable
+            // block has no node
+            std::vector<bool> affected(Blocks.size(), false);
+            std::vector<int> stack;
+            auto it = BlockIndex.find(I->getParent());
+            if(it != BlockIndex.end()) stack.push_back(it->second), affected[it->second] = true;
+            while(not stack.empty()) {
+                int node = stack.back();
+                stack.pop_back();
+
+                Partitions[node].assign(Indexer.size(), -1);
+                if(Blocks[node].predecessors.size() > 1) 
+                    EntryPartitions[node].assign(Indexer.size(), -1);
+                ClosureSignature[node] = 0;
+
+                for(auto succ : Blocks[node].successors)
+                    if(not affected[succ]) affected[succ] = true, stack.push_back(succ);
+            }
+
+            HERBRAND_TIMER(timer, Stats, "fixpoint");
+            HERBRAND_STAT(Stats.startFixpoint(Blocks.size()));
+            std::vector<std::pair<int, int>> priority;
+            findWorklistOrder(priority);
+
+            Counters = CountersTy();
+            solveComponents(priority, Counters, FINAL, &affected);
+            return true;
+        }
+
+        /**
+         * @brief Main Herbrand analysis function.
+         *
+         * @details
+         *  The fixpoint is read from the cache of results if it holds
+         *  the result for the function, and is computed by 
+         *  `computeFixpoint` otherwise.
+         * 
+         * @param[in]   F           Function being analysed, whose control
+         *                          flow graph has been created
+         * @param[in]   verbose     Whether anything is printed, as per
+         *                          `-herbrand-verbosity`
+         * @returns     Void
+         * 
+         * @see     CacheDir, computeFixpoint, Partitions, Indexer, Parent,
+         *          Verbosity
+         **/
+        void HerbrandAnalysis(Function &F, bool verbose) {
+            VerbosityTy verbosity = (verbose ? (VerbosityTy)Verbosity : FINAL);
+            if(verbosity != FINAL) {
+                PRINT_HEADER("Herbrand Equivalence Computation");
+                errs() << "\n";
+            }
+
+            // assign index to expressions
+            assignIndex(F);
+
+            // the result cached for the same function and options, if
+            // any, is used instead of computing the fixpoint
+            std::string cacheFile;
+            uint64_t hash = 0;
+            if(not CacheDir.empty())
+                hash = inputHash(F), cacheFile = ResultFormat::cacheFileName(CacheDir, hash);
+
+            if(not cacheFile.empty() and readResult(cacheFile, hash)) {
+                if(verbosity != FINAL) errs() << "Result read from " << cacheFile << "\n\n\n";
+            } else {
+                computeFixpoint(verbosity);
+                if(not cacheFile.empty() and not writeResult(cacheFile, hash))
+                    errs() << "Could not write " << cacheFile << "\n";
+            }
+
+            if(not BinaryDir.empty()) {
+                std::string fname = BinaryDir + "/" + F.getName().str() + ".herb";
+                if(not writeResult(fname)) errs() << "Could not write " << fname << "\n";
+            }
+            if(not verbose) return;
+            if(verbosity != FINAL) errs() << "\n\n";
+
+            // the partitions are written in large blocks
+            BufferedErrs buffered;
+            HERBRAND_TIMER(timer, Stats, "print");
+
+            PRINT_HEADER("Final Partitions");
+            errs() << "Converged after " << Counters.Iterations << " iterations ("
+                   << Counters.Transfers << " transfer, " << Counters.Confluences
+                   << " confluence)\n\n";
+
+            // partitions inside a basic block are found by applying its
+            // instructions one after another from its entry
+            int blockCnt = Blocks.size();
+            Partition partition;
+            for(int i = 1; i < blockCnt; i++) {
+                BlockNodeTy &node = Blocks[i];
+                if(node.NodeTy == BlockNodeTy::END) {
+                    printNode(node.cfgIndex, Partitions[i]);
+                    continue;
+                }
+
+                if(node.predecessors.size() > 1) 
+                    printNode(node.cfgIndex, EntryPartitions[i]);
+
+                partition = entryPartition(i);
+                for(Instruction &I : *node.bbPtr) {
+                    transferFunction(partition, &I);
+                    printNode(CfgIndex[&I], partition);
+                }
+            }
+        }
+
+#if HERBRAND_STATS
+        /**
+         * @brief
+         *  Adds the counters and timers of the analysis of a function
+         *  to the report written at exit.
+         *
+         * @param[in]   F   Function analysed
+         * @returns     Void
+         *
+         * @see     StatsReport
+         **/
+        void reportStats(Function &F) {
+            StatsReport::get().add(Stats.toJson(F.getName().str(), Counters.Iterations,
+                                                Counters.Transfers, Counters.Confluences, SetCnt));
+        }
+#endif
+
+        /**
+         * @brief
+         *  Saves the partition at each program point of the control
+         *  flow graph to a result file, once the fixpoint is computed.
+         *
+         * @details
+         *  The program points are in the order of their CFG indexes and
+         *  are labelled by their instruction (or START, END or 
+         *  Confluence). The partition at a node is stored relative to
+         *  the one at its first predecessor, which it mostly shares its
+         *  storage with. `Parent`, `SetCnt` and `Counters` are saved
+         *  too, so that `readResult` can restore them.
+         *
+         * @param[in]   fname       Name of the file to be written
+         * @param[in]   inputHash   Hash of the function, 0 if it is not
+         *                          known
+         * @returns     True if the file was written otherwise false
+         *
+         * @see     inputHash, ResultFile, writeResultFile
+         **/
+        bool writeResult(std::string const &fname, uint64_t inputHash = 0) {
+            ResultContentsTy contents;
+            std::vector<std::string> &expressions = contents.Expressions;
+            expressions.resize(Indexer.size());
+            for(int i = 0; i < Indexer.size(); i++) {
+                raw_string_ostream text(expressions[i]);
+                printExpression(Indexer.expression(i), text);
+            }
+
+            int cfgSize = CFG.size();
+            std::vector<std::string> &labels = contents.Labels;
+            std::vector<int> &bases = contents.Bases;
+            labels.resize(cfgSize), bases.assign(cfgSize, -1);
+            for(int i = 0; i < cfgSize; i++) {
+                raw_string_ostream text(labels[i]);
+                if(CFG[i].NodeTy == CfgNodeTy::START) text << "START";
+                else if(CFG[i].NodeTy == CfgNodeTy::END) text << "END";
+                else if(CFG[i].NodeTy == CfgNodeTy::CONFLUENCE) text << "Confluence";
+                else text << *CFG[i].instPtr;
+
+                if(not CFG[i].predecessors.empty()) bases[i] = CFG[i].predecessors[0];
+            }
+
+            // partitions at the program points, found as they are
+            // printed by `HerbrandAnalysis`. The transfer functions may
+            // create set identifiers and `Parent` entries, which are
+            // dropped afterwards so that writing the file does not 
+            // change the state of the analysis
+            int setCnt = SetCnt;
+            FlatHashMap parent = Parent;
+
+            std::vector<Partition> &points = contents.Points;
+            points.resize(cfgSize);
+            points[0] = Partitions[0];
+            for(int i = 1; i < (int)Blocks.size(); i++) {
+                BlockNodeTy &node = Blocks[i];
+                if(node.NodeTy == BlockNodeTy::END) {
+                    points[node.cfgIndex] = Partitions[i];
+                    continue;
+                }
+
+                if(node.predecessors.size() > 1) 
+                    points[node.cfgIndex] = EntryPartitions[i];
+
+                Partition partition = entryPartition(i);
+                for(Instruction &I : *node.bbPtr) {
+                    transferFunction(partition, &I);
+                    points[CfgIndex[&I]] = partition;
+                }
+
+                // the partition at the exit as found by the fixpoint, 
+                // which differs only in the set identifiers of classes
+                // created by the last transfer functions
+                points[CfgIndex[&node.bbPtr->back()]] = Partitions[i];
+            }
+            SetCnt = setCnt, Parent = std::move(parent);
+
+            contents.InputHash = inputHash, contents.SetCnt = SetCnt;
+            Parent.forEach([&](uint64_t key, int setId) { contents.Parent.push_back({key, setId}); });
+            contents.Iterations = Counters.Iterations, contents.Transfers = Counters.Transfers;
+            contents.Confluences = Counters.Confluences;
+
+            return writeResultFile(fname, contents);
+        }
+
+        /**
+         * @brief
+         *  Restores the state of the analysis on convergence from a
+         *  result file written by `writeResult`.
+         *
+         * @details
+         *  The file is used only if it was written for a function with
+         *  the same hash and has as many expressions and program points
+         *  as this function. The partitions at the exit of the basic 
+         *  blocks, and at the entry of those with several predecessors,
+         *  are those at their program points, and `Parent`, `SetCnt` and
+         *  `Counters` are as they were when the file was written.
+         *
+         * @param[in]   fname       Name of the file
+         * @param[in]   inputHash   Hash of the function
+         * @returns     True if the state was restored otherwise false
+         *
+         * @see     inputHash, ResultFile, writeResult
+         **/
+        bool readResult(std::string const &fname, uint64_t inputHash) {
+            ResultFile result;
+            if(not result.open(fname) or result.inputHash() != inputHash or
+               result.numExpressions() != Indexer.size() or
+               result.numPoints() != (int)CFG.size())
+                return false;
+
+            std::vector<Partition> points;
+            result.readPartitions(points);
+
+            int blockCnt = Blocks.size();
+            Partitions.assign(blockCnt, Partition());
+            EntryPartitions.assign(blockCnt, Partition());
+            ClosureSignature.assign(blockCnt, 0);
+            for(int i = 0; i < blockCnt; i++) {
+                BlockNodeTy &node = Blocks[i];
+                if(node.NodeTy != BlockNodeTy::BLOCK) {
+                    Partitions[i] = points[node.cfgIndex];
+                    continue;
+                }
+
+                if(node.predecessors.size() > 1) EntryPartitions[i] = points[node.cfgIndex];
+                Partitions[i] = points[CfgIndex[&node.bbPtr->back()]];
+            }
+
+            Parent.clear();
+            result.forEachParent([&](uint64_t key, int setId) { Parent.assign(key, setId); });
+            SetCnt = LiveSetCnt = result.setCnt();
+
+            Counters.Iterations = result.iterations(), Counters.Transfers = result.transfers();
+            Counters.Confluences = result.confluences();
+            return true;
+        }
+
+        /**
+         * @brief
+         *  Hash of a function and of the options its result depends 
+         *  on, which keys the cache of results.
+         *
+         * @details
+         *  The function is hashed as the text of its basic blocks, 
+         *  with the values numbered as in the function, so neither its
+         *  name nor the other functions of the module change the hash.
+         *
+         * @param[in]   F   The function
+         * @returns     The hash
+         *
+         * @see     CacheDir, readResult
+         **/
+        uint64_t inputHash(Function &F) {
+            std::string text;
+            raw_string_ostream textOut(text);
+            textOut << ResultFormat::Version << ' ' << SparseMode << ' ' << WavefrontMode
+                    << ' ' << CompactThreshold << " [";
+            for(char op : Ops) textOut << op;
+            textOut << "]\n";
+
+            ModuleSlotTracker slots(F.getParent(), false);
+            slots.incorporateFunction(F);
+            for(BasicBlock &BB : F) {
+                BB.printAsOperand(textOut, false, slots);
+                textOut << ":\n";
+                for(Instruction &I : BB) I.print(textOut, slots), textOut << '\n';
+            }
+
+            return ResultFormat::hashString(textOut.str());
+        }
+    };
+
+    class HerbrandEquivalenceAnalysis;
+
+    /**
+     * @brief Result of Herbrand Equivalence analysis of a function.
+     *
+     * @details
+     *  Holds the partition before and after each reachable
+     *  instruction, along with the indexing of the expressions and
+     *  the `Parent` map they refer to, and answers whether two 
+     *  expressions are equivalent at a program point. It does not
+     *  refer to the `AnalysisContext` which computed it, so it stays
+     *  valid after the context is gone. The partitions share their storage,
+     *  so keeping one for each instruction costs little more than
+     *  keeping one for each basic block.
+     *
+     *  A program point which is not reachable has the TOP 
+     *  partition, where all the expressions are equivalent.
+     *
+     * @see     HerbrandEquivalenceAnalysis, Partition
+     **/
+    class HerbrandEquivalenceInfo {
+    public:
+        /**
+         * @brief
+         *  Method to check whether two expressions are equivalent
+         *  just before an instruction.
+         *
+         * @param   e1      First expression
+         * @param   e2      Second expression
+         * @param   I       The instruction
+         *
+         * @returns     True if the expressions are equivalent
+         *              otherwise false
+         **/
+        bool equivalentBefore(ExpressionTy const &e1, ExpressionTy const &e2,
+                              Instruction const *I) const {
+            return equivalent(partitionBefore(I), e1, e2);
+        }
+
+        /**
+         * @brief
+         *  Method to check whether two expressions are equivalent
+         *  just after an instruction.
+         *
+         * @param   e1      First expression
+         * @param   e2      Second expression
+         * @param   I       The instruction
+         *
+         * @returns     True if the expressions are equivalent
+         *              otherwise false
+         **/
+        bool equivalentAfter(ExpressionTy const &e1, ExpressionTy const &e2,
+                             Instruction const *I) const {
+            auto it = After.find(I);
+            return equivalent(it == After.end() ? nullptr : &it->second, e1, e2);
+        }
+
+        /**
+         * @brief
+         *  Method to check whether two constants/variables are
+         *  equivalent just before an instruction.
+         **/
+        bool equivalentBefore(Value *v1, Value *v2, Instruction const *I) const {
+            return equivalentBefore(EXP(v1), EXP(v2), I);
+        }
+
+        /**
+         * @brief
+         *  Method to check whether two constants/variables are
+         *  equivalent just after an instruction.
+         **/
+        bool equivalentAfter(Value *v1, Value *v2, Instruction const *I) const {
+            return equivalentAfter(EXP(v1), EXP(v2), I);
+        }
+
+        /**
+         * @brief Method to check whether an instruction is reachable.
+         **/
+        bool isReachable(Instruction const *I) const { return After.count(I); }
+
+        /**
+         * @brief
+         *  Method to print the partition after each instruction of
+         *  a function.
+         *
+         * @param   F       The function analysed
+         *
+         * @returns     None
+         **/
+        void print(Function &F) const {
+            for(BasicBlock &BB : F)
+                for(Instruction &I : BB) {
+                    errs() << '[' << BB.getName() << "] " << I << "\n\t";
+
+                    auto it = After.find(&I);
+                    if(it == After.end()) errs() << "<TOP ELEMENT>";
+                    else printPartition(it->second, Indexer);
+                    errs() << "\n\n";
+                }
+        }
+
+        /**
+         * @brief
+         *  Method called by the analysis manager to check whether
+         *  the result is still valid. It refers to instructions and
+         *  values of the function, so it is invalidated unless the
+         *  analysis (or all analyses on functions) is preserved.
+         **/
+        bool invalidate(Function &F, PreservedAnalyses const &PA,
+                        FunctionAnalysisManager::Invalidator &);
+
+    private:
+        friend class HerbrandEquivalenceAnalysis;
+
+        /**
+         * @brief
+         *  Method returning the partition just before an instruction,
+         *  `nullptr` if it is not reachable.
+         **/
+        Partition const *partitionBefore(Instruction const *I) const {
+            if(Instruction const *prev = I->getPrevNode()) {
+                auto it = After.find(prev);
+                return it == After.end() ? nullptr : &it->second;
+            }
+
+            auto it = Entry.find(I->getParent());
+            return it == Entry.end() ? nullptr : &it->second;
+        }
+
+        /**
+         * @brief
+         *  Method returning an identifier of the class of an
+         *  expression in a partition, `~0` if it is in a class of
+         *  its own.
+         *
+         * @details
+         *  This is the set identifier of the expression, except for
+         *  a length two expression which is not indexed in sparse
+         *  mode. Its set identifier is the one mapped by `Parent` to
+         *  its `packKey`, and if there is none it is in a fresh class
+         *  which is identified by the key with the highest bit set
+         *  (as in `confluenceClosure`).
+         **/
+        uint64_t classOf(Partition const &partition, ExpressionTy const &exp) const {
+            int idx = Indexer.index(exp);
+            if(idx != -1) return partition[idx];
+            if(std::get<0>(exp) == '\0') return ~0ULL;
+
+            int left = Indexer.valueIndex(std::get<1>(exp));
+            int right = Indexer.valueIndex(std::get<2>(exp));
+            if(left == -1 or right == -1) return ~0ULL;
+
+            uint64_t key = packKey(std::get<0>(exp), partition[left], partition[right]);
+            int setId = Parent.find(key);
+            return setId != -1 ? setId : key | 1ULL << 63;
+        }
+
+        /**
+         * @brief
+         *  Method to check whether two expressions are equivalent in
+         *  a partition, `nullptr` standing for the TOP partition.
+         **/
+        bool equivalent(Partition const *partition, ExpressionTy const &e1,
+                        ExpressionTy const &e2) const {
+            if(e1 == e2 or partition == nullptr or (*partition)[0] == -1) return true;
+
+            uint64_t class1 = classOf(*partition, e1);
+            return class1 != ~0ULL and class1 == classOf(*partition, e2);
+        }
+
+        /**
+         * @brief   Indexing of the expressions in the partitions.
+         **/
+        ExpressionIndexer Indexer;
+
+        /**
+         * @brief   `Parent` map on convergence.
+         **/
+        FlatHashMap Parent;
+
+        /**
+         * @brief   Partition after each reachable instruction.
+         **/
+        DenseMap<Instruction const *, Partition> After;
+
+        /**
+         * @brief   Partition at the entry of each reachable basic block.
+         **/
+        DenseMap<BasicBlock const *, Partition> Entry;
+    };
+
+    /**
+     * @brief
+     *  Herbrand Equivalence analysis for the new pass manager.
+     *
+     * @details
+     *  The result is cached by the function analysis manager, so
+     *  passes querying it reuse the fixpoint until a pass which
+     *  does not preserve it changes the function. Unlike the legacy
+     *  pass it does not rename the values of the function and does
+     *  not print anything, see `HerbrandEquivalencePrinterPass`.
+     *
+     * @see     HerbrandEquivalenceInfo
+     **/
+    class HerbrandEquivalenceAnalysis
+            : public AnalysisInfoMixin<HerbrandEquivalenceAnalysis> {
+    public:
+        typedef HerbrandEquivalenceInfo Result;
+
+        /**
+         * @brief   Method running the analysis on a function.
+         **/
+        Result run(Function &F, FunctionAnalysisManager &) { return analyse(F, threadCount()); }
+
+        /**
+         * @brief
+         *  Method computing the result for a function, without an
+         *  analysis manager. It only reads the function, so different
+         *  functions can be analysed at the same time. With 
+         *  `-herbrand-wavefront` the function is solved on 
+         *  `numThreads` threads.
+         **/
+        static Result analyse(Function &F, int numThreads = 1) {
+            AnalysisContext ctx;
+            ctx.NumThreads = numThreads;
+            ctx.createCFG(F);
+            ctx.HerbrandAnalysis(F, false);
+            HERBRAND_STAT(ctx.reportStats(F));
+
+            // partitions inside a basic block are found by applying
+            // its instructions one after another from its entry
+            Result result;
+            for(int i = 1; i < (int)ctx.Blocks.size(); i++) {
+                BlockNodeTy &node = ctx.Blocks[i];
+                if(node.NodeTy == BlockNodeTy::END) continue;
+
+                Partition partition = ctx.entryPartition(i);
+                result.Entry[node.bbPtr] = partition;
+                for(Instruction &I : *node.bbPtr) {
+                    ctx.transferFunction(partition, &I);
+                    result.After[&I] = partition;
+                }
+            }
+
+            result.Indexer = std::move(ctx.Indexer);
+            result.Parent = std::move(ctx.Parent);
+            return result;
+        }
+
+    private:
+        friend AnalysisInfoMixin<HerbrandEquivalenceAnalysis>;
+        static AnalysisKey Key;
+    };
+
+    AnalysisKey HerbrandEquivalenceAnalysis::Key;
+
+    bool HerbrandEquivalenceInfo::invalidate(Function &, PreservedAnalyses const &PA,
+                                             FunctionAnalysisManager::Invalidator &) {
+        auto PAC = PA.getChecker<HerbrandEquivalenceAnalysis>();
+        return not (PAC.preserved() or PAC.preservedSet<AllAnalysesOn<Function>>());
+    }
+
+    /**
+     * @brief
+     *  Results of Herbrand Equivalence analysis of the functions of
+     *  a module, in the order of the functions in the module.
+     *
+     * @see     analyseModule
+     **/
+    typedef std::vector<std::pair<Function *, HerbrandEquivalenceInfo>> ModuleResultTy;
+
+    /**
+     * @brief
+     *  Analyses all the functions of a module defined in it, on
+     *  `NumThreads` threads.
+     *
+     * @details
+     *  Each function is analysed in its own `AnalysisContext`, as a
+     *  task of a work-stealing `ThreadPool`. The tasks are submitted
+     *  in decreasing number of instructions, so the largest functions
+     *  start first and do not finish long after the others. Each task
+     *  writes only its own entry of the result.
+     *
+     * @param   M       The module
+     * @returns         Result for each function defined in the module
+     *
+     * @see     HerbrandEquivalenceAnalysis::analyse, NumThreads
+     **/
+    ModuleResultTy analyseModule(Module &M) {
+        ModuleResultTy results;
+        for(Function &F : M)
+            if(not F.isDeclaration())
+                results.emplace_back(&F, HerbrandEquivalenceInfo());
+
+        std::vector<int> order(results.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+            return results[a].first->getInstructionCount() > 
+                   results[b].first->getInstructionCount();
+        });
+
+        int numThreads = threadCount();
+        ThreadPool pool(std::min<int>(numThreads, results.size()));
+        // the threads are already busy with other functions, so each
+        // function is solved on a single thread
+        for(int i : order)
+            pool.submit([&results, i] {
+                results[i].second = HerbrandEquivalenceAnalysis::analyse(*results[i].first);
+            });
+        pool.wait();
+
+        return results;
+    }
+
+    /**
+     * @brief
+     *  Pass printing the result of `HerbrandEquivalenceAnalysis`,
+     *  the partition after each instruction of a function.
+     *
+     * @details
+     *  Like the legacy pass, it first names the basic blocks and
+     *  the variables so that the partitions can be read. Names do
+     *  not affect the analysis, so all analyses are preserved.
+     **/
+    struct HerbrandEquivalencePrinterPass
+            : public PassInfoMixin<HerbrandEquivalencePrinterPass> {
+        PreservedAnalyses run(Function &F, FunctionAnalysisManager &FAM) {
+            assignNames(F);
+
+            HerbrandEquivalenceInfo &result = FAM.getResult<HerbrandEquivalenceAnalysis>(F);
+
+            BufferedErrs buffered;
+            PRINT_HEADER("Herbrand Equivalence of " + F.getName().str());
+            errs() << "\n";
+            result.print(F);
+
+            return PreservedAnalyses::all();
+        }
+    };
+
+    /**
+     * @brief
+     *  Prints the results of `analyseModule` for a module, in the
+     *  same format as `HerbrandEquivalencePrinterPass`.
+     *
+     * @details
+     *  The functions are named first, before any thread reads them.
+     *  The results are printed once all of them are computed, in the
+     *  order of the functions in the module.
+     *
+     * @param   M       The module
+     * @returns         Void
+     **/
+    void printModule(Module &M) {
+        for(Function &F : M)
+            if(not F.isDeclaration()) assignNames(F);
+
+        ModuleResultTy results = analyseModule(M);
+
+        BufferedErrs buffered;
+        for(auto &result : results) {
+            PRINT_HEADER("Herbrand Equivalence of " + result.first->getName().str());
+            errs() << "\n";
+            result.second.print(*result.first);
+        }
+    }
+
+    /**
+     * @brief
+     *  Pass analysing all the functions of a module in parallel and
+     *  printing the results, for the new pass manager.
+     *
+     * @details
+     *  Run with `-passes='print<herbrand-equivalence-module>'`. The
+     *  results are not cached in the function analysis manager.
+     *
+     * @see     analyseModule, printModule
+     **/
+    struct HerbrandEquivalenceModulePrinterPass
+            : public PassInfoMixin<HerbrandEquivalenceModulePrinterPass> {
+        PreservedAnalyses run(Module &M, ModuleAnalysisManager &) {
+            printModule(M);
+            return PreservedAnalyses::all();
+        }
+    };
+
+    /**
+     * @brief Body of the pass
+     **/
+    struct HerbrandPass : public FunctionPass {
+        // LLVM uses ID’s address to identify a pass
+        static char ID;
+
+        // constructor - calls base class constructor
+        HerbrandPass() : FunctionPass(ID) {}
+
+        // the function pass
+        bool runOnFunction(Function &F) override {
+            // state of the analysis of this function
+            AnalysisContext ctx;
+            ctx.NumThreads = threadCount();
+
+            // assign names to variables; create control flow graph
+            assignNames(F), ctx.createCFG(F);
+            if(Verbosity != FINAL) {
+                HERBRAND_TIMER(timer, ctx.Stats, "print");
+                printCode(F), ctx.printCFG();
+            }
+
+            // perform Herbrand Analysis
+            ctx.HerbrandAnalysis(F, true);
+            HERBRAND_STAT(ctx.reportStats(F));
+
+            // return false, because the pass is not making changes
+            // in the input file
+            return false;
+        }
+    };
+
+    /**
+     * @brief
+     *  Body of the module pass, analysing all the functions of a
+     *  module in parallel.
+     *
+     * @see     analyseModule, printModule
+     **/
+    struct HerbrandModulePass : public ModulePass {
+        // LLVM uses ID’s address to identify a pass
+        static char ID;
+
+        // constructor - calls base class constructor
+        HerbrandModulePass() : ModulePass(ID) {}
+
+        // the module pass, only the names of the values are changed
+        bool runOnModule(Module &M) override {
+            printModule(M);
+            return false;
+        }
+    };
+}
+
+// initialse static variable ID and register the pass
 char HerbrandPass::HerbrandPass::ID = 0;
 static RegisterPass<HerbrandPass::HerbrandPass> 
         Pass("HerbrandPass", "Herbrand equivalence analysis");
+
+char HerbrandPass::HerbrandModulePass::ID = 0;
+static RegisterPass<HerbrandPass::HerbrandModulePass> 
+        ModulePass("HerbrandModulePass", "Herbrand equivalence analysis of all functions in parallel");
+
+// register the analysis and its printers with the new pass manager,
+// the printers are run with `-passes='print<herbrand-equivalence>'`
+// and `-passes='print<herbrand-equivalence-module>'`
+extern "C" LLVM_ATTRIBUTE_WEAK PassPluginLibraryInfo llvmGetPassPluginInfo() {
+    return {
+        LLVM_PLUGIN_API_VERSION, "HerbrandPass", "v0.1",
+        [](PassBuilder &PB) {
+            PB.registerAnalysisRegistrationCallback(
+                [](FunctionAnalysisManager &FAM) {
+                    FAM.registerPass([] { return HerbrandPass::HerbrandEquivalenceAnalysis(); });
+                });
+            PB.registerPipelineParsingCallback(
+                [](StringRef Name, FunctionPassManager &FPM,
+                   ArrayRef<PassBuilder::PipelineElement>) {
+                    if(Name != "print<herbrand-equivalence>") return false;
+                    FPM.addPass(HerbrandPass::HerbrandEquivalencePrinterPass());
+                    return true;
+                });
+            PB.registerPipelineParsingCallback(
+                [](StringRef Name, ModulePassManager &MPM,
+                   ArrayRef<PassBuilder::PipelineElement>) {
+                    if(Name != "print<herbrand-equivalence-module>") return false;
+                    MPM.addPass(HerbrandPass::HerbrandEquivalenceModulePrinterPass());
+                    return true;
+                });
+        }
+    };
+}
@@ -0,0 +1,66 @@
+/**
+ * @file Benchmark.h
+ *  This file defines helpers shared by the benchmarks, for reading
+ *  the program of a test case and timing operations.
+ **/
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include<cassert>
+#include<chrono>
+#include<cstdio>
+#include<fstream>
+#include<iostream>
+#include<string>
+#include<vector>
+
+/**
+ * @brief
+ *  Stream buffer which discards everything written to it, used
+ *  to silence the analysis while it is benchmarked.
+ **/
+struct NullBuffer : std::streambuf {
+    int overflow(int ch) override { return ch; }
+};
+
+/**
+ * @brief
+ *  Writes the program text in a file to `out`. Test cases in
+ *  the `testcases` folder are accepted as well, for them only
+ *  the section under the *Toy Program* header is written.
+ *
+ * @param[in]   fname   File containing the program
+ * @param[in]   out     File to which the program is written
+ * @return      Void
+ **/
+void extractProgram(std::string fname, std::string out) {
+    std::ifstream fin(fname);
+    assert(fin && "Error opening file");
+
+    std::vector<std::string> lines;
+    std::string buf;
+    while(getline(fin, buf)) lines.push_back(buf);
+
+    // find the section under the *Toy Program* header, if any
+    size_t begin = 0, end = lines.size();
+    for(size_t i = 0; i + 1 < lines.size(); i++) {
+        if(lines[i].compare(0, 11, "Toy Program") != 0) continue;
+        begin = i + 2, end = begin;
+        while(end < lines.size() && lines[end].compare(0, 3, "===") != 0) end++;
+        break;
+    }
+
+    std::ofstream fout(out);
+    for(size_t i = begin; i < end; i++) fout << lines[i] << '\n';
+}
+
+/**
+ * @brief   Returns nanoseconds per operation for `ops` operations.
+ **/
+double nsPerOp(std::chrono::steady_clock::time_point start, size_t ops) {
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / ops;
+}
+
+#endif
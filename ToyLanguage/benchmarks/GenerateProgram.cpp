@@ -0,0 +1,30 @@
+/**
+ * @file GenerateProgram.cpp
+ *  This file writes a random toy program of a given shape, see
+ *  `ProgramGenerator`.
+ **/
+
+#include"ProgramGenerator.h"
+#include<fstream>
+#include<iostream>
+
+int main(int argc, char **argv) {
+    GeneratorOptionsTy options;
+    std::string fname;
+    for(int i = 1; i < argc; i++) {
+        if(parseGeneratorOption(argc, argv, i, options)) continue;
+        if(fname.empty() and argv[i][0] != '-') fname = argv[i];
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--vars N] [--consts N] [--insts N]"
+                      << " [--branch N] [--depth N] [--nondet P] [--seed N] [output file]\n";
+            return 1;
+        }
+    }
+
+    // the program is written to the standard output if no file is given
+    std::ofstream fout;
+    if(not fname.empty()) fout.open(fname);
+    ProgramGenerator generator(options, fname.empty() ? std::cout : fout);
+    generator.generate();
+    return 0;
+}
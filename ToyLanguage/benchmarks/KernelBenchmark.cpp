@@ -0,0 +1,263 @@
+/**
+ * @file KernelBenchmark.cpp
+ *  This file defines micro-benchmarks of the functions at the core
+ *  of the analysis: `findSet`, `getClass`, `samePartition`,
+ *  `transferFunction`, `confluenceFunction` and `assignIndex`. The
+ *  analysis is first run to its fixpoint on a toy program, and the
+ *  functions are then called repeatedly on the partitions it leaves,
+ *  printing the time and the allocations per call.
+ **/
+
+#include"Benchmark.h"
+#include"ProgramGenerator.h"
+#include"../src/HerbrandEquivalence.h"
+#include<cstddef>
+#include<cstdlib>
+#include<new>
+
+/**
+ * @brief   Number and total size of the allocations made so far.
+ **/
+static size_t AllocCnt = 0, AllocBytes = 0;
+
+/**
+ * @brief
+ *  Counts an allocation and makes it, aligned to `align` if it is
+ *  larger than what `malloc` guarantees.
+ *
+ * @return      The memory allocated, `nullptr` if it could not be.
+ **/
+__attribute__((noinline)) static void *countedAlloc(size_t size, size_t align) {
+    AllocCnt++, AllocBytes += size;
+    if(size == 0) size = 1;
+    if(align <= alignof(std::max_align_t)) return std::malloc(size);
+
+    void *ptr;
+    return posix_memalign(&ptr, align, size) == 0 ? ptr : nullptr;
+}
+
+/**
+ * @brief   Frees memory allocated by `countedAlloc`.
+ *
+ * @details
+ *  It is not inlined, so that the compiler does not see `free`
+ *  called on memory returned by `operator new`.
+ **/
+__attribute__((noinline)) static void countedFree(void *ptr) { std::free(ptr); }
+
+/**
+ * @brief   Allocates for `operator new`, throwing if it fails.
+ **/
+static void *countedNew(size_t size, size_t align) {
+    if(void *ptr = countedAlloc(size, align)) return ptr;
+    throw std::bad_alloc();
+}
+
+// every allocation of the benchmark is counted, the kernels being
+// run on a single thread, so all the replaceable allocation
+// functions are replaced
+constexpr size_t DefaultAlign = alignof(std::max_align_t);
+void *operator new(size_t size) { return countedNew(size, DefaultAlign); }
+void *operator new[](size_t size) { return countedNew(size, DefaultAlign); }
+void *operator new(size_t size, std::align_val_t align) { return countedNew(size, (size_t)align); }
+void *operator new[](size_t size, std::align_val_t align) { return countedNew(size, (size_t)align); }
+void *operator new(size_t size, std::nothrow_t const &) noexcept {
+    return countedAlloc(size, DefaultAlign);
+}
+void *operator new[](size_t size, std::nothrow_t const &) noexcept {
+    return countedAlloc(size, DefaultAlign);
+}
+void *operator new(size_t size, std::align_val_t align, std::nothrow_t const &) noexcept {
+    return countedAlloc(size, (size_t)align);
+}
+void *operator new[](size_t size, std::align_val_t align, std::nothrow_t const &) noexcept {
+    return countedAlloc(size, (size_t)align);
+}
+
+void operator delete(void *ptr) noexcept { countedFree(ptr); }
+void operator delete[](void *ptr) noexcept { countedFree(ptr); }
+void operator delete(void *ptr, size_t) noexcept { countedFree(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { countedFree(ptr); }
+void operator delete(void *ptr, std::align_val_t) noexcept { countedFree(ptr); }
+void operator delete[](void *ptr, std::align_val_t) noexcept { countedFree(ptr); }
+void operator delete(void *ptr, size_t, std::align_val_t) noexcept { countedFree(ptr); }
+void operator delete[](void *ptr, size_t, std::align_val_t) noexcept { countedFree(ptr); }
+void operator delete(void *ptr, std::nothrow_t const &) noexcept { countedFree(ptr); }
+void operator delete[](void *ptr, std::nothrow_t const &) noexcept { countedFree(ptr); }
+void operator delete(void *ptr, std::align_val_t, std::nothrow_t const &) noexcept { countedFree(ptr); }
+void operator delete[](void *ptr, std::align_val_t, std::nothrow_t const &) noexcept { countedFree(ptr); }
+
+/**
+ * @brief   Cost of a single call of a function.
+ **/
+struct KernelStatTy {
+    size_t Ops = 0;
+    double NsPerOp = 0, AllocsPerOp = 0, BytesPerOp = 0;
+};
+
+/**
+ * @brief
+ *  Calls a function on each of its inputs in turn until the time
+ *  given has passed, after one call on each input to warm up.
+ *
+ * @details
+ *  `reset` is called before each pass over the inputs and is
+ *  neither timed nor counted, so every pass starts from the same
+ *  state.
+ *
+ * @param[in]   inputs      Number of inputs
+ * @param[in]   seconds     Minimum time for which the function is run
+ * @param[in]   fn          Function called with the index of an input,
+ *                          returning the number of operations made
+ * @param[in]   reset       Function restoring the state
+ * @return      Time, allocations and bytes allocated per operation
+ **/
+template<typename Fn, typename ResetFn>
+KernelStatTy measure(size_t inputs, double seconds, Fn fn, ResetFn reset) {
+    KernelStatTy stat;
+    if(inputs == 0) return stat;
+    reset();
+    for(size_t k = 0; k < inputs; k++) fn(k);
+
+    double elapsed = 0;
+    size_t allocCnt = 0, allocBytes = 0;
+    while(elapsed < seconds * 1e9) {
+        reset();
+        size_t startCnt = AllocCnt, startBytes = AllocBytes;
+        auto start = std::chrono::steady_clock::now();
+        for(size_t k = 0; k < inputs; k++) stat.Ops += fn(k);
+        elapsed += nsPerOp(start, 1);
+        allocCnt += AllocCnt - startCnt, allocBytes += AllocBytes - startBytes;
+    }
+
+    stat.NsPerOp = elapsed / stat.Ops;
+    stat.AllocsPerOp = double(allocCnt) / stat.Ops;
+    stat.BytesPerOp = double(allocBytes) / stat.Ops;
+    return stat;
+}
+
+/**
+ * @brief   Prints the cost of a function.
+ **/
+void printStat(char const *name, KernelStatTy const &stat) {
+    if(stat.Ops == 0) printf("%-20s %12s\n", name, "no inputs");
+    else printf("%-20s %12zu %12.1f %12.2f %12.1f\n", name, stat.Ops, stat.NsPerOp,
+                stat.AllocsPerOp, stat.BytesPerOp);
+}
+
+int main(int argc, char **argv) {
+    GeneratorOptionsTy options;
+    std::string programName;
+    bool sparse = false;
+    double seconds = 0.25;
+
+    for(int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if(parseGeneratorOption(argc, argv, i, options)) continue;
+        if(arg == "--sparse") sparse = true;
+        else if(arg == "--time" and i + 1 < argc) seconds = std::atof(argv[++i]);
+        else if(arg == "--program" and i + 1 < argc) programName = argv[++i];
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--sparse] [--time seconds] [--program file]"
+                      << " [--vars n] [--consts n] [--insts n] [--branch n] [--depth n]"
+                      << " [--nondet p] [--seed n]\n";
+            return 1;
+        }
+    }
+
+    std::string fname = "KernelBenchmark.tmp";
+    if(programName.empty()) {
+        std::ofstream fout(fname);
+        ProgramGenerator(options, fout).generate();
+    } else extractProgram(programName, fname);
+
+    // run the analysis silently to its fixpoint
+    NullBuffer nullBuffer;
+    std::ostream nullStream(&nullBuffer);
+    AnalysisContext ctx(sparse, nullStream);
+    ctx.Verbosity = AnalysisContext::FINAL;
+    ctx.program.parse(fname), ctx.program.createCFG();
+    std::remove(fname.c_str());
+    ctx.assignIndex();
+    ctx.computeFixpoint();
+
+    // nodes whose partition is not TOP, with a copy of each partition
+    // which does not share its storage, and the nodes to which the
+    // transfer and the confluence functions are applied
+    int cfgSize = ctx.program.CFG.size(), numExps = ctx.Indexer.size();
+    std::vector<int> nodes, transferNodes, confluenceNodes;
+    std::vector<Partition> copies(cfgSize);
+    for(int n = 0; n < cfgSize; n++) {
+        auto &predecessors = ctx.program.CFG[n].predecessors;
+        if(predecessors.size() == 1) transferNodes.push_back(n);
+        else if(predecessors.size() > 1) confluenceNodes.push_back(n);
+
+        Partition const &partition = ctx.Partitions[n];
+        if(partition[0] == -1) continue;
+        nodes.push_back(n);
+        copies[n].assign(numExps, -1);
+        for(int i = 0; i < numExps; i++) copies[n].set(i, partition[i]);
+    }
+
+    // set identifiers are created by the kernels (by `findSet` for
+    // keys it has not seen, by the transfer function for `x = *` and
+    // by the confluence function for the classes it splits), so the
+    // state left by the analysis is restored before each pass
+    std::vector<Partition> partitions = ctx.Partitions;
+    FlatHashMap parent = ctx.Parent;
+    std::vector<uint64_t> signatures = ctx.ClosureSignature;
+    int setCnt = ctx.SetCnt;
+    auto reset = [&]() {
+        ctx.Partitions = partitions, ctx.Parent = parent, ctx.ClosureSignature = signatures;
+        ctx.SetCnt = ctx.LiveSetCnt = setCnt;
+    };
+
+    printf("%d CFG nodes (%zu transfer, %zu confluence), %d expressions per partition "
+           "(%d constants and variables), %d set identifiers, %s mode\n",
+           cfgSize, transferNodes.size(), confluenceNodes.size(), numExps,
+           ctx.Indexer.numValues(), setCnt, sparse ? "sparse" : "dense");
+    printf("%-20s %12s %12s %12s %12s\n", "function", "ops", "ns/op", "allocs/op", "bytes/op");
+
+    long long checksum = 0;
+    printStat("findSet", measure(nodes.size(), seconds, [&](size_t k) {
+        Partition const &partition = ctx.Partitions[nodes[k]];
+        for(int i = ctx.Indexer.numValues(); i < numExps; i++) checksum += ctx.findSet(partition, i);
+        return numExps - ctx.Indexer.numValues();
+    }, reset));
+
+    std::set<int> expClass;
+    printStat("getClass", measure(nodes.size(), seconds, [&](size_t k) {
+        ctx.getClass(ctx.Partitions[nodes[k]], (k * 31) % numExps, expClass);
+        checksum += expClass.size();
+        return 1;
+    }, reset));
+
+    printStat("samePartition", measure(nodes.size(), seconds, [&](size_t k) {
+        checksum += ctx.samePartition(ctx.Partitions[nodes[k]], copies[nodes[k]]);
+        return 1;
+    }, reset));
+
+    // the partitions are at the fixpoint, so applying the functions
+    // again leaves them the same
+    printStat("transferFunction", measure(transferNodes.size(), seconds, [&](size_t k) {
+        ctx.transferFunction(transferNodes[k]);
+        return 1;
+    }, reset));
+
+    printStat("confluenceFunction", measure(confluenceNodes.size(), seconds, [&](size_t k) {
+        ctx.confluenceFunction(confluenceNodes[k]);
+        return 1;
+    }, reset));
+
+    // the partitions left by the last pass must still be the fixpoint
+    bool same = true;
+    for(int n : nodes) same = same and ctx.samePartition(ctx.Partitions[n], copies[n]);
+
+    printStat("assignIndex", measure(1, seconds, [&](size_t) {
+        ctx.assignIndex();
+        return 1;
+    }, reset));
+
+    printf("checksum %lld%s\n", checksum, same ? "" : " | PARTITIONS CHANGED");
+    return not same;
+}
@@ -0,0 +1,136 @@
+/**
+ * @file ParentMapBenchmark.cpp
+ *  This file defines a micro-benchmark comparing `FlatHashMap`
+ *  against `std::map` for the `Parent` map. The keys are those
+ *  left in `Parent` after running Herbrand Equivalence analysis
+ *  on a toy program, either read from a file or synthesised.
+ **/
+
+#include"Benchmark.h"
+#include"../src/HerbrandEquivalence.h"
+#include<algorithm>
+#include<random>
+
+/**
+ * @brief
+ *  Writes a synthetic toy program with loops to a file.
+ *
+ * @details
+ *  The program has `numVars` variables and `numVars / 2` constants.
+ *  It consists of `numVars / 4` loops, each of which has eight
+ *  random assignments (with one in eight being non-deterministic)
+ *  and jumps back to its beginning or falls through.
+ *
+ * @param[in]   numVars     Number of variables in the program
+ * @param[in]   out         File to which the program is written
+ * @return      Void
+ **/
+void syntheticProgram(int numVars, std::string out) {
+    std::mt19937 rng(numVars);
+    int numConsts = std::max(1, numVars / 2);
+
+    auto var = [&]() { return "v" + std::to_string(rng() % numVars); };
+    auto operand = [&]() {
+        if(rng() % 3 == 0) return std::to_string(rng() % numConsts);
+        return var();
+    };
+
+    std::ofstream fout(out);
+    int numLoops = std::max(1, numVars / 4);
+    for(int loop = 0; loop < numLoops; loop++) {
+        fout << "LABEL L" << loop << '\n';
+        for(int i = 0; i < 8; i++) {
+            fout << var() << " = ";
+            if(rng() % 8 == 0) fout << "*\n";
+            else if(rng() % 2) fout << operand() << '\n';
+            else fout << operand() << " + " << operand() << '\n';
+        }
+        fout << "GOTO L" << loop << " L" << loop + 1 << '\n';
+    }
+    fout << "LABEL L" << numLoops << '\n';
+}
+
+int main(int argc, char **argv) {
+    if(argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <program file> | --synthetic <variables>\n";
+        return 1;
+    }
+
+    std::string fname = "ParentMapBenchmark.tmp", label;
+    if(std::string(argv[1]) == "--synthetic" && argc > 2) {
+        syntheticProgram(std::stoi(argv[2]), fname);
+        label = std::string("synthetic-") + argv[2];
+    } else {
+        extractProgram(argv[1], fname);
+        label = argv[1];
+    }
+
+    // run the analysis silently to populate `Parent`
+    NullBuffer nullBuffer;
+    std::ostream nullStream(&nullBuffer);
+    AnalysisContext ctx(false, nullStream);
+    ctx.Verbosity = AnalysisContext::FINAL;
+    ctx.program.parse(fname), ctx.program.createCFG();
+    ctx.HerbrandEquivalence();
+    std::remove(fname.c_str());
+
+    // keys present in `Parent` and as many keys which are not
+    // present, made from set identifiers not allocated yet
+    std::vector<std::tuple<char, int, int>> hits, misses;
+    ctx.Parent.forEach([&](uint64_t key, int) {
+        hits.emplace_back(keyOp(key), keyLeft(key), keyRight(key));
+    });
+
+    std::mt19937 rng(hits.size());
+    for(size_t i = 0; i < hits.size(); i++)
+        misses.emplace_back('+', ctx.SetCnt + rng() % 1024, rng() % (ctx.SetCnt + 1));
+
+    std::vector<std::tuple<char, int, int>> queries(hits);
+    queries.insert(queries.end(), misses.begin(), misses.end());
+    std::shuffle(queries.begin(), queries.end(), rng);
+    std::shuffle(hits.begin(), hits.end(), rng);
+
+    // each lookup is repeated until at least a million are made
+    size_t rounds = std::max<size_t>(1, 1000000 / std::max<size_t>(1, queries.size()));
+    long long checksum = 0;
+
+    // std::map
+    auto start = std::chrono::steady_clock::now();
+    std::map<std::tuple<char, int, int>, int> treeMap;
+    for(auto &key : hits) treeMap.insert({key, (int)treeMap.size()});
+    double treeInsert = nsPerOp(start, hits.size());
+
+    start = std::chrono::steady_clock::now();
+    for(size_t r = 0; r < rounds; r++)
+        for(auto &key : queries) {
+            auto it = treeMap.find(key);
+            checksum += (it == treeMap.end() ? -1 : it->second);
+        }
+    double treeFind = nsPerOp(start, rounds * queries.size());
+
+    // FlatHashMap
+    start = std::chrono::steady_clock::now();
+    FlatHashMap flatMap;
+    for(auto &key : hits) {
+        uint64_t packed = packKey(std::get<0>(key), std::get<1>(key), std::get<2>(key));
+        flatMap.insert(packed, (int)flatMap.size());
+    }
+    double flatInsert = nsPerOp(start, hits.size());
+
+    start = std::chrono::steady_clock::now();
+    for(size_t r = 0; r < rounds; r++)
+        for(auto &key : queries)
+            checksum -= flatMap.find(packKey(std::get<0>(key), std::get<1>(key),
+                                             std::get<2>(key)));
+    double flatFind = nsPerOp(start, rounds * queries.size());
+
+    // both maps give the same values, so the checksum must be zero
+    assert(checksum == 0 && "Maps disagree");
+
+    printf("%-24s entries %8zu | std::map insert %7.1f ns find %7.1f ns"
+           " | FlatHashMap insert %7.1f ns find %7.1f ns | find speedup %5.2fx\n",
+           label.c_str(), hits.size(), treeInsert, treeFind, flatInsert, flatFind,
+           treeFind / flatFind);
+
+    return checksum != 0;
+}
@@ -0,0 +1,320 @@
+/**
+ * @file ParserBenchmark.cpp
+ *  This file defines a benchmark measuring the throughput of
+ *  `Program::parse`, which maps the file into memory and interns
+ *  the identifiers in hash tables, against the parser reading the
+ *  file with `getline` and `std::stringstream` which it replaced.
+ *  It also times interning the variables of the program in
+ *  `MapVector` and `InternMapVector`.
+ **/
+
+#include"Benchmark.h"
+#include"../src/MapVector.h"
+#include"../src/Program.h"
+#include<map>
+#include<random>
+#include<sstream>
+
+/**
+ * @brief
+ *  Parses an assignment instruction the way the `std::stringstream`
+ *  based parser did.
+ *
+ * @param[in]   program     Program whose `Constants` and `Variables`
+ *                          the operands are added to
+ * @param[in]   text        Text of the instruction
+ * @return      The instruction
+ **/
+Program::InstructionTy legacyParseInstruction(Program &program, std::string const &text) {
+    std::stringstream ss(text);
+    std::string in;
+    ss >> in;
+
+    int constVal;
+    Program::ValueTy lValue, leftOp, rightOp;
+    char op = '\0';
+
+    try {
+        constVal = std::stoi(in.c_str());
+        assert(false && "LValue is not a variable");
+    } catch(std::invalid_argument &) {
+        lValue = {false, program.Variables.insert(in).first};
+
+        in.clear(), ss >> in;
+        assert(in == "=" && "No RValue specified");
+
+        in.clear(), ss >> in;
+        assert(!in.empty() && "No RValue specified");
+
+        try {
+            constVal = std::stoi(in.c_str());
+            leftOp = {true, program.Constants.insert(constVal).first};
+        } catch(std::invalid_argument &) {
+            if(in == "*") op = '#', leftOp = {false, -1};
+            else leftOp = {false, program.Variables.insert(in).first};
+        }
+
+        in.clear(), ss >> in;
+        assert((op != '#' || in.empty()) && "Invalid instruction");
+
+        if(!in.empty()) {
+            if(in.length() == 1) {
+                switch(in[0]) {
+                    case '+':
+                    case '-':
+                    case '*':
+                    case '/': op = in[0];
+                }
+            }
+            assert(op != '\0' && "Invalid operand");
+
+            in.clear(), ss >> in;
+            assert(!in.empty() && "Second operand not specified");
+
+            try {
+                constVal = std::stoi(in.c_str());
+                rightOp = {true, program.Constants.insert(constVal).first};
+            } catch(std::invalid_argument &) {
+                rightOp = {false, program.Variables.insert(in).first};
+            }
+        } else rightOp = {false, -1};
+    }
+
+    return {lValue, {op, leftOp, rightOp}, false, -1, {}};
+}
+
+/**
+ * @brief
+ *  Parses a program the way the `std::stringstream` based parser
+ *  did, reading it line by line and resolving the labels through
+ *  a `std::map`.
+ *
+ * @param[in]   program     Program to which the instructions are added
+ * @param[in]   fname       File containing the program
+ * @return      Void
+ **/
+void legacyParse(Program &program, std::string fname) {
+    std::ifstream fin(fname);
+    assert(fin && "Error opening file");
+
+    int instCnt = 1;
+    std::string buf;
+    std::vector<std::vector<std::string>> jumps;
+    std::map<std::string, int> labels;
+
+    Program::InstructionTy dummy = {{false, -1}, {'\0', {false, -1}, {false, -1}}, false, {}};
+    program.Instructions.emplace_back(dummy);
+    jumps.emplace_back(std::vector<std::string>());
+
+    while(getline(fin, buf)) {
+        if(buf.empty()) continue;
+
+        std::stringstream ss(buf);
+        std::string in;
+        ss >> in;
+
+        if(in == "GOTO") {
+            while(ss >> in)
+                jumps[instCnt - 1].push_back(in);
+        } else if(in == "LABEL") {
+            while(ss >> in) {
+                assert(labels.find(in) == labels.end() && "Duplicate label found");
+                labels[in] = instCnt;
+            }
+        } else {
+            program.Instructions.push_back(legacyParseInstruction(program, buf));
+            jumps.emplace_back(std::vector<std::string>());
+            instCnt++;
+        }
+    }
+
+    program.Instructions.push_back(dummy);
+    jumps.emplace_back(std::vector<std::string>());
+    instCnt++;
+
+    auto &instructions = program.Instructions;
+    std::queue<int> q;
+    q.push(0), instructions[0].reachable = true;
+
+    while(not q.empty()) {
+        int cur = q.front();
+        q.pop();
+
+        if(not jumps[cur].empty()) {
+            for(auto el : jumps[cur]) {
+                auto it = labels.find(el);
+                assert(it != labels.end() && "Undefined label found");
+                if(it->second == instCnt) continue;
+
+                instructions[it->second].predecessors.insert(cur);
+                if(not instructions[it->second].reachable) {
+                    instructions[it->second].reachable = true;
+                    q.push(it->second);
+                }
+            }
+        } else {
+            if(cur + 1 == instCnt) continue;
+
+            instructions[cur + 1].predecessors.insert(cur);
+            if(not instructions[cur + 1].reachable) {
+                instructions[cur + 1].reachable = true;
+                q.push(cur + 1);
+            }
+        }
+    }
+}
+
+/**
+ * @brief
+ *  Writes a synthetic toy program of straight line blocks joined
+ *  by jumps to a file.
+ *
+ * @details
+ *  The program has `numInsts` instructions over `numInsts / 4`
+ *  variables and `numInsts / 16` constants, so that most of the
+ *  identifiers are seen several times. Every sixteen instructions
+ *  are labelled and end with a jump to their own label or to a
+ *  random later one.
+ *
+ * @param[in]   numInsts    Number of instructions in the program
+ * @param[in]   out         File to which the program is written
+ * @return      Void
+ **/
+void syntheticProgram(int numInsts, std::string out) {
+    std::mt19937 rng(numInsts);
+    int numVars = std::max(1, numInsts / 4), numConsts = std::max(1, numInsts / 16);
+    int numBlocks = std::max(1, numInsts / 16);
+
+    auto var = [&]() { return "var" + std::to_string(rng() % numVars); };
+    auto operand = [&]() {
+        if(rng() % 3 == 0) return std::to_string(rng() % numConsts);
+        return var();
+    };
+
+    std::ofstream fout(out);
+    for(int block = 0; block < numBlocks; block++) {
+        fout << "LABEL block" << block << '\n';
+        for(int i = 0; i < 16; i++) {
+            fout << var() << " = ";
+            if(rng() % 8 == 0) fout << "*\n";
+            else if(rng() % 2) fout << operand() << '\n';
+            else fout << operand() << " + " << operand() << '\n';
+        }
+        int later = block + 1 + rng() % 4;
+        fout << "GOTO block" << block << " block" << std::min(later, numBlocks) << '\n';
+    }
+    fout << "LABEL block" << numBlocks << '\n';
+}
+
+/**
+ * @brief
+ *  Checks that two parsed programs have the same constants,
+ *  variables and instructions.
+ **/
+bool sameProgram(Program &first, Program &second) {
+    if(first.Variables.size() != second.Variables.size() or
+       first.Constants.size() != second.Constants.size() or
+       first.Instructions.size() != second.Instructions.size()) return false;
+
+    for(int i = 0; i < (int)first.Variables.size(); i++)
+        if(first.Variables[i] != second.Variables[i]) return false;
+    for(int i = 0; i < (int)first.Constants.size(); i++)
+        if(first.Constants[i] != second.Constants[i]) return false;
+
+    auto sameValue = [](Program::ValueTy a, Program::ValueTy b) {
+        return a.isConst == b.isConst and a.index == b.index;
+    };
+    for(int i = 0; i < (int)first.Instructions.size(); i++) {
+        auto &a = first.Instructions[i], &b = second.Instructions[i];
+        if(not sameValue(a.lValue, b.lValue) or a.rValue.op != b.rValue.op or
+           not sameValue(a.rValue.leftOp, b.rValue.leftOp) or
+           not sameValue(a.rValue.rightOp, b.rValue.rightOp) or
+           a.reachable != b.reachable or a.predecessors != b.predecessors) return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    if(argc < 2) {
+        std::cerr << "Usage: " << argv[0]
+                  << " <program file> | --synthetic <instructions> [repeats]\n";
+        return 1;
+    }
+
+    std::string fname = "ParserBenchmark.tmp", label;
+    int argIdx = 2;
+    if(std::string(argv[1]) == "--synthetic" && argc > 2) {
+        syntheticProgram(std::stoi(argv[2]), fname);
+        label = std::string("synthetic-") + argv[2];
+        argIdx = 3;
+    } else {
+        extractProgram(argv[1], fname);
+        label = argv[1];
+    }
+    int repeats = (argIdx < argc ? std::max(1, std::stoi(argv[argIdx])) : 5);
+
+    std::ifstream fin(fname, std::ios::binary | std::ios::ate);
+    double megabytes = fin.tellg() / 1e6;
+    fin.close();
+
+    // the best of the repeats is taken for each parser, the file
+    // being in the page cache after the first one
+    double legacyTime = 1e30, mappedTime = 1e30;
+    bool same = true;
+    for(int r = 0; r < repeats; r++) {
+        NullBuffer nullBuffer;
+        std::ostream nullStream(&nullBuffer);
+        Program legacy(nullStream), mapped(nullStream);
+
+        auto start = std::chrono::steady_clock::now();
+        legacyParse(legacy, fname);
+        legacyTime = std::min(legacyTime, nsPerOp(start, 1) / 1e9);
+
+        start = std::chrono::steady_clock::now();
+        mapped.parse(fname);
+        mappedTime = std::min(mappedTime, nsPerOp(start, 1) / 1e9);
+
+        same = same and sameProgram(legacy, mapped);
+    }
+
+    // each occurrence of a variable in the program, copied out of
+    // the program so that both tables intern the same strings
+    NullBuffer nullBuffer;
+    std::ostream nullStream(&nullBuffer);
+    Program program(nullStream);
+    legacyParse(program, fname);
+    std::remove(fname.c_str());
+
+    std::vector<std::string> names;
+    for(auto &inst : program.Instructions) {
+        Program::ValueTy values[] = {inst.lValue, inst.rValue.leftOp, inst.rValue.rightOp};
+        for(auto &value : values)
+            if(not value.isConst and value.index != -1)
+                names.emplace_back(program.Variables[value.index]);
+    }
+
+    double treeInsert = 1e30, hashInsert = 1e30;
+    long long checksum = 0;
+    for(int r = 0; r < repeats and not names.empty(); r++) {
+        MapVector<std::string> tree;
+        auto start = std::chrono::steady_clock::now();
+        for(auto &name : names) checksum += tree.insert(name).first;
+        treeInsert = std::min(treeInsert, nsPerOp(start, names.size()));
+
+        InternMapVector<std::string> hash;
+        start = std::chrono::steady_clock::now();
+        for(auto &name : names) checksum -= hash.insert(name).first;
+        hashInsert = std::min(hashInsert, nsPerOp(start, names.size()));
+    }
+
+    // both tables give the same integers, so the checksum must be zero
+    same = same and checksum == 0;
+
+    printf("%-24s %9.2f MB | getline/stringstream %8.1f MB/s | mmap/string_view %8.1f MB/s"
+           " | speedup %5.2fx | %zu names: MapVector %6.1f ns InternMapVector %6.1f ns%s\n",
+           label.c_str(), megabytes, megabytes / legacyTime, megabytes / mappedTime,
+           legacyTime / mappedTime, names.size(), treeInsert, hashInsert,
+           same ? "" : " | RESULTS DIFFER");
+
+    return not same;
+}
@@ -0,0 +1,235 @@
+/**
+ * @file ProgramGenerator.h
+ *  This file defines a generator of random toy programs whose
+ *  size and shape (variables, constants, instructions, branching,
+ *  loop nesting and non-deterministic assignments) are given.
+ **/
+
+#ifndef PROGRAMGENERATOR_H
+#define PROGRAMGENERATOR_H
+
+#include<algorithm>
+#include<cstdint>
+#include<cstdlib>
+#include<ostream>
+#include<random>
+#include<string>
+#include<vector>
+
+/**
+ * @brief
+ *  Shape of the programs generated by `ProgramGenerator`.
+ **/
+struct GeneratorOptionsTy {
+    /**
+     * @brief   Number of variables, named `v0`, `v1`, ...
+     **/
+    int Variables = 16;
+
+    /**
+     * @brief   Number of constants, `0`, `1`, ... (none if zero).
+     **/
+    int Constants = 4;
+
+    /**
+     * @brief
+     *  Number of assignment instructions, and so (about) the
+     *  number of nodes in the control flow graph.
+     **/
+    int Instructions = 256;
+
+    /**
+     * @brief
+     *  Number of successors of a branch, 1 for programs without
+     *  branches other than the exits of loops.
+     **/
+    int Branching = 2;
+
+    /**
+     * @brief   Depth upto which loops are nested, 0 for no loops.
+     **/
+    int LoopDepth = 2;
+
+    /**
+     * @brief   Fraction of the assignments which are `x = *`.
+     **/
+    double NondetDensity = 0.125;
+
+    /**
+     * @brief   Seed of the random number generator.
+     **/
+    unsigned Seed = 1;
+};
+
+/**
+ * @brief
+ *  Parses an option of the generator from the command line.
+ *
+ * @details
+ *  The options are `--vars N`, `--consts N`, `--insts N`,
+ *  `--branch N`, `--depth N`, `--nondet P` and `--seed N`.
+ *
+ * @param[in]       argc        Number of arguments
+ * @param[in]       argv        Arguments
+ * @param[in,out]   i           Index of the option, moved to its
+ *                              value if it is parsed
+ * @param[out]      options     Options updated
+ * @return      True if the argument was an option of the generator
+ **/
+bool parseGeneratorOption(int argc, char **argv, int &i, GeneratorOptionsTy &options) {
+    std::string arg = argv[i];
+    if(i + 1 >= argc) return false;
+
+    char const *value = argv[i + 1];
+    if(arg == "--vars") options.Variables = std::max(1, std::atoi(value));
+    else if(arg == "--consts") options.Constants = std::max(0, std::atoi(value));
+    else if(arg == "--insts") options.Instructions = std::max(1, std::atoi(value));
+    else if(arg == "--branch") options.Branching = std::max(1, std::atoi(value));
+    else if(arg == "--depth") options.LoopDepth = std::max(0, std::atoi(value));
+    else if(arg == "--nondet") options.NondetDensity = std::atof(value);
+    else if(arg == "--seed") options.Seed = std::strtoul(value, nullptr, 10);
+    else return false;
+
+    i++;
+    return true;
+}
+
+/**
+ * @brief
+ *  Generates a random toy program of a given shape.
+ *
+ * @details
+ *  A program is a sequence of straight line runs of assignments,
+ *  branches and loops, taking their instructions out of a budget.
+ *  A branch jumps to `Branching` arms which meet after them, and a
+ *  loop jumps back to its head or exits, its body being generated
+ *  the same way one level deeper. Loops are not nested deeper than
+ *  `LoopDepth`. Every jump follows an assignment, so the program is
+ *  valid whatever the options.
+ *
+ * @see GeneratorOptionsTy
+ **/
+class ProgramGenerator {
+public:
+    /**
+     * @brief   Constructor for ProgramGenerator class.
+     *
+     * @param   options     Shape of the program
+     * @param   out         Stream to which the program is written
+     **/
+    ProgramGenerator(GeneratorOptionsTy const &options, std::ostream &out) :
+        Options(options), Out(out), Rng(options.Seed), LabelCnt(0), InstCnt(0) {}
+
+    /**
+     * @brief
+     *  Writes the program.
+     *
+     * @returns     The number of assignments written
+     **/
+    int generate() {
+        region(Options.Instructions, 0);
+        Out << "LABEL exit\n";
+        return InstCnt;
+    }
+
+private:
+    /**
+     * @brief   Shape of the program.
+     **/
+    GeneratorOptionsTy Options;
+
+    /**
+     * @brief   Stream to which the program is written.
+     **/
+    std::ostream &Out;
+
+    /**
+     * @brief   Random number generator.
+     **/
+    std::mt19937 Rng;
+
+    /**
+     * @brief   Number of labels and of assignments written so far.
+     **/
+    int LabelCnt, InstCnt;
+
+    /**
+     * @brief   Returns a random integer in `[0, n)`.
+     **/
+    int random(int n) { return std::uniform_int_distribution<int>(0, n - 1)(Rng); }
+
+    /**
+     * @brief   Returns a new label.
+     **/
+    std::string label() { return "L" + std::to_string(LabelCnt++); }
+
+    /**
+     * @brief   Returns a random constant or variable.
+     **/
+    std::string operand() {
+        if(Options.Constants > 0 and random(3) == 0) return std::to_string(random(Options.Constants));
+        return "v" + std::to_string(random(Options.Variables));
+    }
+
+    /**
+     * @brief   Writes a random assignment.
+     **/
+    void assignment() {
+        Out << 'v' << random(Options.Variables) << " = ";
+        if(std::uniform_real_distribution<double>(0, 1)(Rng) < Options.NondetDensity) Out << "*\n";
+        else if(random(2)) Out << operand() << '\n';
+        else Out << operand() << " + " << operand() << '\n';
+        InstCnt++;
+    }
+
+    /**
+     * @brief
+     *  Writes a sequence of runs, branches and loops with atmost
+     *  `budget` assignments.
+     *
+     * @param   budget  Number of assignments to be written
+     * @param   depth   Number of loops the sequence is nested in
+     **/
+    void region(int budget, int depth) {
+        while(budget > 0) {
+            int choice = random(4);
+            if(choice == 0 and depth < Options.LoopDepth and budget >= 3) {
+                // a loop taking upto half of the budget left
+                int size = 2 + random(budget / 2 + 1);
+                std::string head = label(), exit = label();
+                Out << "LABEL " << head << '\n';
+                region(size - 1, depth + 1);
+                assignment();
+                Out << "GOTO " << head << ' ' << exit << '\n';
+                Out << "LABEL " << exit << '\n';
+                budget -= size;
+            } else if(choice == 1 and Options.Branching > 1 and budget >= Options.Branching + 1) {
+                // a branch, whose arms share upto half of the budget left
+                int size = std::min(budget, Options.Branching + 1 + random(budget / 2 + 1));
+                int armSize = (size - 1) / Options.Branching;
+                std::vector<std::string> arms;
+                std::string join = label();
+
+                assignment();
+                Out << "GOTO";
+                for(int i = 0; i < Options.Branching; i++) arms.push_back(label()), Out << ' ' << arms.back();
+                Out << '\n';
+
+                for(auto &arm : arms) {
+                    Out << "LABEL " << arm << '\n';
+                    region(armSize - 1, depth);
+                    assignment();
+                    Out << "GOTO " << join << '\n';
+                }
+                Out << "LABEL " << join << '\n';
+                budget -= size;
+            } else {
+                int size = std::min(budget, 1 + random(4));
+                for(int i = 0; i < size; i++) assignment();
+                budget -= size;
+            }
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,205 @@
+/**
+ * @file ScalingBenchmark.cpp
+ *  This file defines a benchmark running the analysis on programs
+ *  made by `ProgramGenerator`, sweeping one parameter of their shape
+ *  at a time, and writing the time of each phase, the work done by
+ *  the solver and the peak resident memory of each run as CSV.
+ **/
+
+#include"Benchmark.h"
+#include"ProgramGenerator.h"
+#include"../src/HerbrandEquivalence.h"
+#include<sstream>
+#include<sys/resource.h>
+#include<sys/wait.h>
+#include<unistd.h>
+
+/**
+ * @brief   Measurements of a single run of the analysis.
+ **/
+struct RunTy {
+    double ParseTime = 0, CfgTime = 0, IndexTime = 0, FixpointTime = 0;
+    int CfgNodes = 0, Expressions = 0;
+    AnalysisContext::CountersTy Counters;
+    long PeakRss = 0;
+};
+
+/**
+ * @brief
+ *  Runs the analysis on a program in a child process, so that its
+ *  peak resident memory is not mixed with that of earlier runs.
+ *
+ * @param[in]   fname       File containing the program
+ * @param[in]   sparse      Whether the analysis runs in sparse mode
+ * @param[in]   threads     Threads of the wavefront solver, 0 for the
+ *                          sequential solver
+ * @param[out]  run         Measurements of the run
+ * @return      False if the child did not report its measurements
+ **/
+bool runAnalysis(std::string const &fname, bool sparse, int threads, RunTy &run) {
+    int fds[2];
+    if(pipe(fds) != 0) return false;
+
+    pid_t pid = fork();
+    if(pid < 0) return false;
+    if(pid == 0) {
+        close(fds[0]);
+        NullBuffer nullBuffer;
+        std::ostream nullStream(&nullBuffer);
+        AnalysisContext ctx(sparse, nullStream);
+        ctx.Verbosity = AnalysisContext::FINAL;
+        ctx.Wavefront = threads > 0, ctx.NumThreads = std::max(1, threads);
+
+        auto start = std::chrono::steady_clock::now();
+        ctx.program.parse(fname);
+        run.ParseTime = nsPerOp(start, 1) / 1e9;
+
+        start = std::chrono::steady_clock::now();
+        ctx.program.createCFG();
+        run.CfgTime = nsPerOp(start, 1) / 1e9;
+
+        start = std::chrono::steady_clock::now();
+        ctx.assignIndex();
+        run.IndexTime = nsPerOp(start, 1) / 1e9;
+
+        start = std::chrono::steady_clock::now();
+        ctx.computeFixpoint();
+        run.FixpointTime = nsPerOp(start, 1) / 1e9;
+
+        run.CfgNodes = ctx.program.CFG.size(), run.Expressions = ctx.Indexer.size();
+        run.Counters = ctx.Counters;
+        bool written = write(fds[1], &run, sizeof(run)) == (ssize_t)sizeof(run);
+        _exit(written ? 0 : 1);
+    }
+
+    close(fds[1]);
+    bool read = ::read(fds[0], &run, sizeof(run)) == (ssize_t)sizeof(run);
+    close(fds[0]);
+
+    int status;
+    struct rusage usage;
+    if(wait4(pid, &status, 0, &usage) != pid) return false;
+    run.PeakRss = usage.ru_maxrss;
+    return read and WIFEXITED(status) and WEXITSTATUS(status) == 0;
+}
+
+/**
+ * @brief   Parameter of the generator and the values it is set to.
+ **/
+struct SweepTy {
+    std::string Name;
+    std::vector<double> Values;
+};
+
+/**
+ * @brief   Sets the parameter of the generator named `name`.
+ **/
+bool setParameter(GeneratorOptionsTy &options, std::string const &name, double value) {
+    if(name == "vars") options.Variables = std::max(1, (int)value);
+    else if(name == "consts") options.Constants = std::max(0, (int)value);
+    else if(name == "insts") options.Instructions = std::max(1, (int)value);
+    else if(name == "branch") options.Branching = std::max(1, (int)value);
+    else if(name == "depth") options.LoopDepth = std::max(0, (int)value);
+    else if(name == "nondet") options.NondetDensity = value;
+    else if(name == "seed") options.Seed = (unsigned)value;
+    else return false;
+    return true;
+}
+
+int main(int argc, char **argv) {
+    GeneratorOptionsTy base;
+    std::vector<SweepTy> sweeps;
+    std::string csvName;
+    bool sparse = false;
+    int threads = 0, repeats = 1;
+
+    for(int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if(parseGeneratorOption(argc, argv, i, base)) continue;
+        if(arg == "--sparse") sparse = true;
+        else if(arg == "--wavefront" and i + 1 < argc) threads = std::max(1, std::atoi(argv[++i]));
+        else if(arg == "--repeats" and i + 1 < argc) repeats = std::max(1, std::atoi(argv[++i]));
+        else if(arg == "--csv" and i + 1 < argc) csvName = argv[++i];
+        else if(arg == "--sweep" and i + 2 < argc) {
+            SweepTy sweep{argv[i + 1], {}};
+            std::stringstream ss(argv[i + 2]);
+            std::string value;
+            while(getline(ss, value, ',')) sweep.Values.push_back(std::atof(value.c_str()));
+            GeneratorOptionsTy check;
+            if(sweep.Values.empty() or not setParameter(check, sweep.Name, 0)) {
+                std::cerr << "Invalid sweep " << sweep.Name << ' ' << argv[i + 2] << '\n';
+                return 1;
+            }
+            sweeps.push_back(sweep);
+            i += 2;
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--sparse] [--wavefront threads] [--repeats n]"
+                      << " [--csv file] [--vars n] [--consts n] [--insts n] [--branch n]"
+                      << " [--depth n] [--nondet p] [--seed n] [--sweep parameter v1,v2,...]...\n";
+            return 1;
+        }
+    }
+
+    if(sweeps.empty())
+        sweeps = {{"vars", {8, 16, 32, 64}}, {"insts", {250, 500, 1000, 2000}}, {"depth", {0, 1, 2, 3}}};
+
+    std::ofstream csvFile;
+    if(not csvName.empty()) csvFile.open(csvName);
+    std::ostream &csv = (csvName.empty() ? std::cout : csvFile);
+    if(not csv) {
+        std::cerr << "Error opening " << csvName << '\n';
+        return 1;
+    }
+
+    std::string mode = std::string(sparse ? "sparse" : "dense") +
+                       (threads > 0 ? "-wavefront" + std::to_string(threads) : "");
+    csv << "sweep,vars,consts,insts,branch,depth,nondet,seed,mode,cfg_nodes,expressions,"
+           "parse_s,cfg_s,index_s,fixpoint_s,wall_s,iterations,transfers,confluences,peak_rss_kb\n";
+
+    std::string fname = "ScalingBenchmark.tmp";
+    bool failed = false;
+    for(auto &sweep : sweeps) {
+        for(double value : sweep.Values) {
+            GeneratorOptionsTy options = base;
+            setParameter(options, sweep.Name, value);
+            {
+                std::ofstream fout(fname);
+                ProgramGenerator(options, fout).generate();
+            }
+
+            // the fastest of the repeats is kept, along with the
+            // largest peak memory
+            RunTy best;
+            bool ok = false;
+            for(int r = 0; r < repeats; r++) {
+                RunTy run;
+                if(not runAnalysis(fname, sparse, threads, run)) continue;
+                double wall = run.ParseTime + run.CfgTime + run.IndexTime + run.FixpointTime;
+                double bestWall = best.ParseTime + best.CfgTime + best.IndexTime + best.FixpointTime;
+                long peakRss = std::max(best.PeakRss, run.PeakRss);
+                if(not ok or wall < bestWall) best = run;
+                best.PeakRss = peakRss, ok = true;
+            }
+            if(not ok) {
+                std::cerr << "Analysis failed for " << sweep.Name << ' ' << value << '\n';
+                failed = true;
+                continue;
+            }
+
+            char line[512];
+            snprintf(line, sizeof(line),
+                     "%s,%d,%d,%d,%d,%d,%g,%u,%s,%d,%d,%.6f,%.6f,%.6f,%.6f,%.6f,%d,%d,%d,%ld\n",
+                     sweep.Name.c_str(), options.Variables, options.Constants, options.Instructions,
+                     options.Branching, options.LoopDepth, options.NondetDensity, options.Seed,
+                     mode.c_str(), best.CfgNodes, best.Expressions, best.ParseTime, best.CfgTime,
+                     best.IndexTime, best.FixpointTime,
+                     best.ParseTime + best.CfgTime + best.IndexTime + best.FixpointTime,
+                     best.Counters.Iterations, best.Counters.Transfers, best.Counters.Confluences,
+                     best.PeakRss);
+            csv << line << std::flush;
+        }
+    }
+    std::remove(fname.c_str());
+
+    return failed;
+}
@@ -0,0 +1,300 @@
+/**
+ * @file ExpressionIndexer.h
+ *  This file defines an ExpressionIndexer class which maps
+ *  expressions of length atmost two to integer indexes and
+ *  back, either by arithmetic on the indexes of their operators
+ *  and operands or, in sparse mode, only for a given list of
+ *  expressions.
+ **/
+
+#ifndef EXPRESSIONINDEXER_H
+#define EXPRESSIONINDEXER_H
+
+#include<cassert>
+#include<vector>
+#include"FlatHashMap.h"
+#include"Program.h"
+
+/**
+ * @struct ExpressionIndexer
+ * @brief
+ *  Maps expressions of length atmost two to integer indexes and
+ *  back without storing the expressions.
+ *
+ * @details
+ *  With `C` constants, `V` variables and `N = C + V`, the indexes
+ *  are laid out as
+ *  - `i` for the `i`th constant, `0 <= i < C`
+ *  - `C + i` for the `i`th variable, `0 <= i < V`
+ *  - `N + k * N * N + l * N + r` for the expression `l op r` where
+ *    `op` is the `k`th operator and `l`, `r` are the indexes of
+ *    the operands.
+ *
+ *  So the indexes of constants and variables (the *value indexes*)
+ *  are also the indexes of the corresponding expressions.
+ *
+ *  In sparse mode (see `initSparse`) only the length two
+ *  expressions passed are indexed, as `N`, `N + 1`, ... in the
+ *  order given, and `index` returns -1 for the rest. The value
+ *  indexes are the same as above.
+ *
+ * @see Program::ExpressionTy
+ **/
+class ExpressionIndexer {
+public:
+    /**
+     * @brief   Constructor for ExpressionIndexer class.
+     **/
+    ExpressionIndexer() : NumConstants(0), NumValues(0), Sparse(false), OpIndex(256, -1) {}
+
+    /**
+     * @brief Initialises the object for a program.
+     *
+     * @param   numConstants    Number of constants in the program
+     * @param   numVariables    Number of variables in the program
+     * @param   ops             Operators used in the program
+     *
+     * @returns     None
+     **/
+    void init(int numConstants, int numVariables, std::vector<char> const &ops) {
+        NumConstants = numConstants, NumValues = numConstants + numVariables;
+        Ops = ops;
+        OpIndex.assign(256, -1);
+        for(int k = 0; k < (int)Ops.size(); k++)
+            OpIndex[(unsigned char)Ops[k]] = k;
+
+        Sparse = false;
+        TrackedOp.clear(), TrackedLeft.clear(), TrackedRight.clear();
+        TrackedIndex.clear();
+    }
+
+    /**
+     * @brief
+     *  Initialises the object for a program in sparse mode, where
+     *  only the given length two expressions are indexed.
+     *
+     * @param   numConstants    Number of constants in the program
+     * @param   numVariables    Number of variables in the program
+     * @param   ops             Operators used in the program
+     * @param   exps            Length two expressions to be indexed,
+     *                          duplicates are indexed once
+     *
+     * @returns     None
+     **/
+    void initSparse(int numConstants, int numVariables, std::vector<char> const &ops,
+                    std::vector<Program::ExpressionTy> const &exps) {
+        init(numConstants, numVariables, ops);
+        Sparse = true;
+
+        for(auto &exp : exps) {
+            assert(OpIndex[(unsigned char)exp.op] != -1 &&
+                   "Operator not in the list of operators");
+
+            int left = valueIndex(exp.leftOp), right = valueIndex(exp.rightOp);
+            int idx = NumValues + (int)TrackedOp.size();
+            if(not TrackedIndex.insert(packKey(exp.op, left, right), idx).second) continue;
+
+            TrackedOp.push_back(exp.op);
+            TrackedLeft.push_back(left), TrackedRight.push_back(right);
+        }
+    }
+
+    /**
+     * @brief Method to return whether the object is in sparse mode.
+     *
+     * @returns     True if only some length two expressions are
+     *              indexed otherwise false
+     **/
+    bool isSparse() const { return Sparse; }
+
+    /**
+     * @brief Method to return the operators used for indexing.
+     *
+     * @returns     Vector of operators
+     **/
+    std::vector<char> const &ops() const { return Ops; }
+
+    /**
+     * @brief Method to return the number of expressions indexed.
+     *
+     * @returns     The number of constants, variables and length
+     *              two expressions
+     **/
+    int size() const {
+        if(Sparse) return NumValues + (int)TrackedOp.size();
+        return NumValues + (int)Ops.size() * NumValues * NumValues;
+    }
+
+    /**
+     * @brief Method to return the number of constants and variables.
+     *
+     * @returns     The number of value indexes
+     **/
+    int numValues() const { return NumValues; }
+
+    /**
+     * @brief Method to return whether an index is a value index.
+     *
+     * @param   idx     Index of an expression
+     *
+     * @returns     True if the index represents a constant or a
+     *              variable otherwise false
+     **/
+    bool isValue(int idx) const { return idx < NumValues; }
+
+    /**
+     * @brief Method returning index for a constant or a variable.
+     *
+     * @param   value   The constant or variable
+     *
+     * @returns     The value index of the argument
+     **/
+    int valueIndex(Program::ValueTy const &value) const {
+        assert(value.index >= 0 && "Invalid constant/variable");
+        return value.isConst ? value.index : NumConstants + value.index;
+    }
+
+    /**
+     * @brief Method used for forward mapping.
+     *
+     * @param   exp     Expression to be mapped, it must not be a
+     *                  non-deterministic assignment
+     *
+     * @returns     The index corresponding to the expression, in
+     *              sparse mode -1 if it is not indexed
+     **/
+    int index(Program::ExpressionTy const &exp) const {
+        if(exp.op == '\0') return valueIndex(exp.leftOp);
+
+        if(Sparse)
+            return TrackedIndex.find(packKey(exp.op, valueIndex(exp.leftOp),
+                                             valueIndex(exp.rightOp)));
+
+        int k = OpIndex[(unsigned char)exp.op];
+        assert(k != -1 && "Operator not in the list of operators");
+
+        return NumValues + (k * NumValues + valueIndex(exp.leftOp)) * NumValues +
+               valueIndex(exp.rightOp);
+    }
+
+    /**
+     * @brief Method returning the operator of a length two expression.
+     *
+     * @param   idx     Index of a length two expression
+     *
+     * @returns     The operator
+     **/
+    char op(int idx) const {
+        if(Sparse) return TrackedOp[idx - NumValues];
+        return Ops[(idx - NumValues) / (NumValues * NumValues)];
+    }
+
+    /**
+     * @brief
+     *  Method returning value index of left operand of a length
+     *  two expression.
+     *
+     * @param   idx     Index of a length two expression
+     *
+     * @returns     The value index of the left operand
+     **/
+    int leftIndex(int idx) const {
+        if(Sparse) return TrackedLeft[idx - NumValues];
+        return (idx - NumValues) / NumValues % NumValues;
+    }
+
+    /**
+     * @brief
+     *  Method returning value index of right operand of a length
+     *  two expression.
+     *
+     * @param   idx     Index of a length two expression
+     *
+     * @returns     The value index of the right operand
+     **/
+    int rightIndex(int idx) const {
+        if(Sparse) return TrackedRight[idx - NumValues];
+        return (idx - NumValues) % NumValues;
+    }
+
+    /**
+     * @brief Method used for reverse mapping a value index.
+     *
+     * @param   idx     Value index
+     *
+     * @returns     The constant or variable corresponding to the index
+     **/
+    Program::ValueTy value(int idx) const {
+        if(idx < NumConstants) return {true, idx};
+        return {false, idx - NumConstants};
+    }
+
+    /**
+     * @brief Method used for reverse mapping.
+     *
+     * @param   idx     Index of an expression
+     *
+     * @returns     The expression corresponding to the index
+     **/
+    Program::ExpressionTy expression(int idx) const {
+        assert(idx >= 0 && idx < size() && "Expression index out of range");
+        if(isValue(idx)) return {'\0', value(idx), {false, -1}};
+        return {op(idx), value(leftIndex(idx)), value(rightIndex(idx))};
+    }
+
+    /**
+     * @brief
+     *  Method to return the number of bytes allocated by the object.
+     *  Nothing is allocated per expression in dense mode.
+     *
+     * @returns     The bytes held by the object
+     **/
+    size_t memoryUsage() const {
+        return Ops.capacity() + OpIndex.capacity() * sizeof(int) + TrackedOp.capacity() +
+               (TrackedLeft.capacity() + TrackedRight.capacity()) * sizeof(int) +
+               TrackedIndex.memoryUsage();
+    }
+
+private:
+    /**
+     * @brief   Number of constants.
+     **/
+    int NumConstants;
+
+    /**
+     * @brief   Number of constants and variables.
+     **/
+    int NumValues;
+
+    /**
+     * @brief   Operators used in the program.
+     **/
+    std::vector<char> Ops;
+
+    /**
+     * @brief   Whether only the expressions in `Tracked*` are indexed.
+     **/
+    bool Sparse;
+
+    /**
+     * @brief   Position of each operator in `Ops`, -1 if absent.
+     **/
+    std::vector<int> OpIndex;
+
+    /**
+     * @brief
+     *  Operator and value indexes of the operands of each length
+     *  two expression indexed in sparse mode.
+     **/
+    std::vector<char> TrackedOp;
+    std::vector<int> TrackedLeft, TrackedRight;
+
+    /**
+     * @brief
+     *  Index of each length two expression indexed in sparse mode,
+     *  keyed by `packKey` of its operator and operand value indexes.
+     **/
+    FlatHashMap TrackedIndex;
+};
+
+#endif
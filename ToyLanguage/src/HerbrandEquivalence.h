@@ -0,0 +1,2068 @@
+/** 
+ * @file HerbrandEquivalence.h
+ *  This file implements algorithm for Herbrand
+ *  Equivalence analysis.
+ **/
+
+#ifndef HERBRANDEQUIVALENCE_H
+#define HERBRANDEQUIVALENCE_H
+
+#include"ExpressionIndexer.h"
+#include"FlatHashMap.h"
+#include"MemoryUsage.h"
+#include"Partition.h"
+#include"Program.h"
+#include"ResultFile.h"
+#include"Stats.h"
+#include"ThreadPool.h"
+#include<map>
+#include<sstream>
+#include<stdexcept>
+#include<unordered_map>
+
+// simple macro to print a header line to an output stream
+#ifndef PRINT_HEADER
+#define PRINT_HEADER(os, str) (os) << std::string(100, '=') << '\n' << (str) \
+                                   << '\n' << std::string(100, '=') << '\n';
+#endif
+
+#define VAR_VAL(x) {false, x}
+#define NULL_VAL {false, -1}
+#define CONST_VAL(x) {true, x}
+
+/**
+ * @brief Hash function for a tuple of set identifiers.
+ * 
+ * @details
+ *  Used to key `std::unordered_map` with the set identifiers 
+ *  of an expression across the predecessors of a confluence 
+ *  point.
+ * 
+ * @see confluenceClosure, confluenceFunction
+ **/
+struct SetIdTupleHash {
+    template<typename T>
+    size_t operator()(std::vector<T> const &tup) const {
+        size_t seed = tup.size();
+        for(auto el : tup)
+            seed ^= std::hash<T>()(el) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        return seed;
+    }
+};
+
+/**
+ * @brief
+ *  Vector of operators used in the program.
+ * 
+ * @note
+ *  This vector needs to be updated by adding operators
+ *  if the programs on which it is being run contains
+ *  more operators.
+ **/
+inline const std::vector<char> Ops({'+'});
+
+/**
+ * @brief
+ *  State of Herbrand Equivalence analysis of a toy program,
+ *  along with the functions computing it.
+ *
+ * @details
+ *  An object is created for each program being analysed and
+ *  nothing is shared between two objects, so different programs
+ *  can be analysed at the same time from different threads. The
+ *  program is parsed into `program`, its control flow graph is 
+ *  created, and then `HerbrandEquivalence` computes the fixpoint.
+ *
+ * @see     HerbrandEquivalence, Program
+ **/
+class AnalysisContext {
+public:
+    /**
+     * @brief   Constructor for AnalysisContext class
+     * 
+     * @param   sparseMode  Whether only the expressions appearing in
+     *                      the program are tracked (`SparseMode`)
+     * @param   out         Output stream to print to, standard output
+     *                      by default
+     **/
+    AnalysisContext(bool sparseMode = false, std::ostream &out = std::cout)
+        : SparseMode(sparseMode), Out(out), program(out) {}
+
+    /**
+     * @brief
+     *  Whether only the constants, variables and the length two
+     *  expressions appearing in the program are tracked.
+     *
+     * @details
+     *  In this mode partitions hold set identifiers only for the
+     *  expressions indexed by `Indexer`, which are linear in the
+     *  size of the program. The set identifier of any other length
+     *  two expression `l op r` at a program point is implicitly
+     *  the one mapped by `Parent` to `op` and the set identifiers of
+     *  `l` and `r` there, and a fresh one if there is none. 
+     *  `confluenceClosure` keeps `Parent` consistent with this at 
+     *  confluence points.
+     *
+     * @see     ClosureSignature, confluenceClosure, Indexer
+     **/
+    bool SparseMode;
+
+    /**
+     * @brief
+     *  Whether the fixpoint is computed by `solveWavefront`, solving
+     *  independent parts of the control flow graph at the same time,
+     *  instead of `solveComponents`.
+     *
+     * @see     NumThreads, solveWavefront
+     **/
+    bool Wavefront = false;
+
+    /**
+     * @brief   Number of threads used by `solveWavefront`.
+     **/
+    int NumThreads = 1;
+
+    /**
+     * @brief   Amount of output printed by `HerbrandEquivalence`.
+     **/
+    enum VerbosityTy {
+        /** Only the partitions once the fixpoint is computed */
+        FINAL,
+        /** Also a line for each node processed */
+        SUMMARY,
+        /** Also the partition at each node processed */
+        TRACE
+    };
+
+    /**
+     * @brief
+     *  Amount of output printed by `HerbrandEquivalence`, the full
+     *  trace by default. Below `TRACE` the partitions at the nodes
+     *  processed are not even looked at.
+     *
+     * @see     VerbosityTy
+     **/
+    VerbosityTy Verbosity = TRACE;
+
+    /**
+     * @brief
+     *  Directory of the cache of results, nothing is cached if it
+     *  is empty.
+     *
+     * @details
+     *  The result for a program is saved as a result file named by
+     *  `inputHash`, and is read back instead of computing the 
+     *  fixpoint when the same program is analysed with the same
+     *  options. It is read back only with `Verbosity` at `FINAL`,
+     *  as the nodes processed are printed above it.
+     *
+     * @see     inputHash, readResult, writeResult
+     **/
+    std::string CacheDir;
+
+    /**
+     * @brief
+     *  Whether a snapshot of the memory is taken at the end of each
+     *  phase.
+     *
+     * @see     MemorySnapshots, recordMemory
+     **/
+    bool MemoryReport = false;
+
+    /**
+     * @brief
+     *  Resident memory in bytes which the process may not go over,
+     *  no limit if 0.
+     *
+     * @details
+     *  The budget is checked at the end of each phase, and before
+     *  the fixpoint is computed against the least memory the
+     *  partitions will take. While it is computed, the budget is
+     *  checked every `MemoryCheckInterval` nodes processed, after
+     *  each wavefront, and before the set identifiers are compacted
+     *  against the copies `compact` makes. A `MemoryBudgetError` is
+     *  thrown if it would be exceeded, once a snapshot of the memory
+     *  is taken. Several programs analysed at the same time share
+     *  the budget, as it bounds the whole process.
+     *
+     * @see     checkMemoryBudget, MemoryBudgetError
+     **/
+    size_t MemoryBudget = 0;
+
+    /**
+     * @brief
+     *  Nodes processed between two checks of `MemoryBudget` while
+     *  the fixpoint is computed.
+     **/
+    static constexpr int MemoryCheckInterval = 256;
+
+    /**
+     * @brief
+     *  Snapshots of the memory taken at the end of each phase, with
+     *  `MemoryReport`, and on exceeding `MemoryBudget`.
+     *
+     * @see     MemorySnapshotTy, recordMemory
+     **/
+    std::vector<MemorySnapshotTy> MemorySnapshots;
+
+    /**
+     * @brief
+     *  Output stream to which the program and the analysis are
+     *  printed.
+     **/
+    std::ostream &Out;
+
+    /**
+     * @brief Captures a program text.
+     * 
+     * @see     Program
+     **/
+    Program program;
+
+    /**
+     * @brief
+     *  Maps expressions to integer indexes and back. This
+     *  indexing is fixed in the beginning and used throughout
+     *  wherever indexing is required for the expressions.
+     * 
+     * @see     ExpressionIndexer, Partitions
+     **/
+    ExpressionIndexer Indexer;
+
+    /**
+     * @brief
+     *  Reverse index from constants and variables to the
+     *  length two expressions using them.
+     *
+     * @details
+     *  `UsedBy[i]` holds the indexes of the length two
+     *  expressions which have the constant or variable with
+     *  index `i` as one of their operands. After an assignment
+     *  only these expressions can get a new set identifier.
+     *
+     * @see     Indexer, transferFunction
+     **/
+    std::vector<std::vector<int>> UsedBy;
+
+    /**
+     * @brief
+     *  Counter to keep track of set identifiers. New set 
+     *  identifiers are created by incrementing this counter.
+     * 
+     * @see     Partitions, Program::ExpressionTy
+     **/
+    int SetCnt = 0;
+
+    /**
+     * @brief
+     *  Smallest value of `SetCnt` at which the set identifiers are
+     *  compacted, 0 to never compact them.
+     *
+     * @details
+     *  The set identifiers are compacted once `SetCnt` reaches this
+     *  value and twice the number of set identifiers left by the 
+     *  last compaction, so the work of a compaction is paid for by
+     *  the set identifiers created since the last one, and `Parent`
+     *  and `SetCnt` stay proportional to the set identifiers in the
+     *  partitions. `packKey` allows atmost 2^28 set identifiers.
+     *
+     * @see     compact, maybeCompact
+     **/
+    int CompactThreshold = 1 << 16;
+
+    /**
+     * @brief   Number of set identifiers left by the last compaction.
+     *
+     * @see     compact
+     **/
+    int LiveSetCnt = 0;
+
+    /**
+     * @brief
+     *  Vector to keep track of equivalence classes at each
+     *  program point.
+     * 
+     * @details
+     *  There is an entry for each program point in this vector
+     *  which itself is a `Partition` containing an entry for each
+     *  expression of length atmost two. The entries for the
+     *  expressions contains integer set identifiers. For a
+     *  given program point two expressions are equivalent iff
+     *  they have the same set identifier.
+     *
+     * @note
+     *  A partition copied from a predecessor shares its storage
+     *  except for the leaves where it differs, so memory grows
+     *  with the number of changes made along the program rather
+     *  than with the number of program points.
+     *
+     * @see     Indexer, Partition, SetCnt
+     **/
+    std::vector<Partition> Partitions;
+
+    /**
+     * @brief
+     *  `FlatHashMap` to hold parent set identifiers.
+     * 
+     * @details
+     *  a1 =~ a2 and b1 =~ b2 at a program point iff
+     *  (a1 + b1) =~ (a2 + b2). Parent map helps us 
+     *  to resolve this by storing set identifiers of 
+     *  compound expression (a1 + b1) as parent of set 
+     *  identifiers of its smaller sub-expressions (a1 
+     *  and b1). Now, later when a new expression is 
+     *  formed by combining expressions (a2 and b2) with 
+     *  same set identifiers as those of the two 
+     *  sub-expressions (a1 and b1), we assign it 
+     *  (a2 + b2) the same identifier as the previous 
+     *  compound expression (a1 + b1).
+     *  This map also helps to resolve other complex 
+     *  cases where some equivalence classes are lost in 
+     *  the middle of the program but appears later.
+     *  
+     * 
+     * @note
+     *  The key of this map packs the operator along with the
+     *  two set identifiers (which are ordered) using `packKey`.
+     *  Also this map is shared by all the program points.
+     * 
+     * @see     Indexer, packKey, Partitions, SetCnt
+     **/
+    FlatHashMap Parent;
+
+    /**
+     * @brief
+     *  Hash of the `Parent` entries made by `confluenceClosure` at
+     *  each confluence point on its last evaluation, in sparse mode.
+     *
+     * @details
+     *  The implicit classes at a confluence point can change while
+     *  its partition stays same, so in sparse mode a confluence 
+     *  point has changed iff its partition or this hash has changed.
+     *
+     * @see     confluenceClosure, SparseMode
+     **/
+    std::vector<uint64_t> ClosureSignature;
+
+    /**
+     * @brief 
+     *  Sets up `Indexer` for the constants, variables and
+     *  operators of the program. Also fills the reverse index
+     *  `UsedBy`.
+     * 
+     * @return  Void
+     * 
+     * @see     Indexer, Program::ExpressionTy, UsedBy
+     **/
+    void assignIndex() {
+        HERBRAND_TIMER(timer, Stats, "assignIndex");
+        if(SparseMode) {
+            // only the length two expressions appearing in the program
+            std::vector<Program::ExpressionTy> exps;
+            for(auto &inst : program.Instructions)
+                if(inst.rValue.op != '\0' and inst.rValue.op != '#')
+                    exps.push_back(inst.rValue);
+
+            Indexer.initSparse(program.Constants.size(), program.Variables.size(), Ops, exps);
+        } else Indexer.init(program.Constants.size(), program.Variables.size(), Ops);
+
+        // record each length two expression against its operands,
+        // an expression with the same operand on both the sides is
+        // recorded once
+        UsedBy.assign(Indexer.numValues(), {});
+        for(int i = Indexer.numValues(); i < Indexer.size(); i++) {
+            int leftIdx = Indexer.leftIndex(i), rightIdx = Indexer.rightIndex(i);
+
+            UsedBy[leftIdx].push_back(i);
+            if(rightIdx != leftIdx) UsedBy[rightIdx].push_back(i);
+        }
+    }
+
+    /**
+     * @brief
+     *  Counts the bytes held by each data structure of the analysis
+     *  and reads the resident memory of the process.
+     *
+     * @param[in]   phase   Phase after which the snapshot is taken.
+     * @return      The snapshot.
+     *
+     * @see     MemorySnapshotTy
+     **/
+    MemorySnapshotTy memoryUsage(std::string const &phase) const {
+        MemorySnapshotTy snapshot;
+        snapshot.Phase = phase;
+        snapshot.Partitions = Partition::memoryUsage(Partitions) +
+                              Partitions.capacity() * sizeof(Partition) +
+                              ClosureSignature.capacity() * sizeof(uint64_t);
+        snapshot.Parent = Parent.memoryUsage();
+
+        snapshot.Indexer = Indexer.memoryUsage() + UsedBy.capacity() * sizeof(std::vector<int>);
+        for(auto &el : UsedBy) snapshot.Indexer += el.capacity() * sizeof(int);
+
+        snapshot.CFG = program.cfgMemoryUsage();
+        snapshot.Program = program.memoryUsage();
+
+        // the peak is updated lazily, so it can lag the resident memory
+        snapshot.Rss = residentMemory();
+        snapshot.PeakRss = std::max(peakResidentMemory(), snapshot.Rss);
+        return snapshot;
+    }
+
+    /**
+     * @brief
+     *  Takes a snapshot of the memory at the end of a phase if
+     *  `MemoryReport` is set, and checks `MemoryBudget`.
+     *
+     * @param[in]   phase   Phase which has ended.
+     * @return      Void
+     *
+     * @see     checkMemoryBudget, MemorySnapshots
+     **/
+    void recordMemory(std::string const &phase) {
+        if(MemoryReport) MemorySnapshots.push_back(memoryUsage(phase));
+        checkMemoryBudget(phase);
+    }
+
+    /**
+     * @brief
+     *  Throws a `MemoryBudgetError` if the resident memory of the
+     *  process along with the bytes about to be allocated goes over
+     *  `MemoryBudget`, once a snapshot of the memory is taken.
+     *
+     * @param[in]   phase   Phase in which the budget is checked.
+     * @param[in]   bytes   Bytes about to be allocated.
+     * @return      Void
+     *
+     * @see     MemoryBudget, MemorySnapshots
+     **/
+    void checkMemoryBudget(std::string const &phase, size_t bytes = 0) {
+        if(MemoryBudget == 0) return;
+        bytes += residentMemory();
+        if(bytes <= MemoryBudget) return;
+
+        MemorySnapshots.push_back(memoryUsage(phase + " (over budget)"));
+        throw MemoryBudgetError(phase, bytes, MemoryBudget);
+    }
+
+    /**
+     * @brief
+     *  Scratch space used by `samePartition` for relabelling set
+     *  identifiers of the two partitions being compared.
+     *
+     * @details
+     *  `CanonicalLabel[k][id]` holds `{stamp, label}` for the set 
+     *  identifier `id` in the `k`th partition. A label is valid only 
+     *  if its stamp equals `CanonicalStamp`, which is incremented on
+     *  every comparison, so the vectors never have to be cleared.
+     *
+     * @see samePartition
+     **/
+    std::vector<std::pair<int, int>> CanonicalLabel[2];
+
+    /**
+     * @brief Current stamp for `CanonicalLabel` entries.
+     *
+     * @see CanonicalLabel, samePartition
+     **/
+    int CanonicalStamp = 0;
+
+    /**
+     * @brief   Number of nodes processed while computing the fixpoint.
+     **/
+    struct CountersTy {
+        int Iterations = 0, Transfers = 0, Confluences = 0;
+    };
+
+    /**
+     * @brief   Nodes processed while computing the fixpoint.
+     **/
+    CountersTy Counters;
+
+#if HERBRAND_STATS
+    /**
+     * @brief
+     *  Counters and timers of the analysis, compiled in only with
+     *  `HERBRAND_STATS`.
+     *
+     * @see     SolverStatsTy
+     **/
+    SolverStatsTy Stats;
+#endif
+
+    /**
+     * @brief
+     *  State of a worker solving a strongly connected component of
+     *  the control flow graph in wavefront mode.
+     *
+     * @details
+     *  Components of the same wavefront are solved at the same time
+     *  and must not see the changes made by each other, so while a
+     *  wavefront is solved `Parent` and `SetCnt` are only read. A 
+     *  worker makes its `Parent` entries in its own map, which is
+     *  looked up before `Parent`, and creates provisional set
+     *  identifiers counting from `SetCnt`. Once the wavefront is
+     *  solved `commitWorker` replaces them by set identifiers of 
+     *  the context.
+     *
+     * @see     commitWorker, solveWavefront
+     **/
+    struct WorkerTy {
+        /**
+         * @brief   Nodes of the component, in the order of their priority.
+         **/
+        std::vector<int> Nodes;
+
+        /**
+         * @brief   `Parent` entries made by the worker.
+         **/
+        FlatHashMap Parent;
+
+        /**
+         * @brief
+         *  First provisional set identifier, and the one to be
+         *  created next.
+         **/
+        int Base = 0, SetCnt = 0;
+
+        /**
+         * @brief
+         *  For each provisional set identifier, the `Parent` key for
+         *  which `findSet` created it, or `~0` if it was created
+         *  otherwise.
+         **/
+        std::vector<uint64_t> Origin;
+
+        /**
+         * @brief   Scratch space of `samePartition` for the worker.
+         *
+         * @see     CanonicalLabel, CanonicalStamp
+         **/
+        std::vector<std::pair<int, int>> CanonicalLabel[2];
+        int CanonicalStamp = 0;
+
+        /**
+         * @brief   Nodes processed by the worker.
+         **/
+        CountersTy Counters;
+
+#if HERBRAND_STATS
+        /**
+         * @brief   `findSet` lookups of the worker, see `SolverStatsTy`.
+         **/
+        long long FindSetHits = 0, FindSetMisses = 0;
+#endif
+    };
+
+    /**
+     * @brief
+     *  Creates a new set identifier, a provisional one if `worker`
+     *  is not `nullptr`.
+     *
+     * @see     SetCnt, WorkerTy
+     **/
+    int allocSetId(WorkerTy *worker) {
+        if(not worker) return SetCnt++;
+
+        worker->Origin.push_back(~0ULL);
+        return worker->SetCnt++;
+    }
+
+    /**
+     * @brief
+     *  Returns the set identifier mapped to a key by `Parent`, or 
+     *  by the map of `worker` if it is not `nullptr` and has the
+     *  key. Returns -1 if there is none.
+     *
+     * @see     Parent, WorkerTy
+     **/
+    int findParent(uint64_t key, WorkerTy const *worker) const {
+        if(worker) {
+            int setId = worker->Parent.find(key);
+            if(setId != -1) return setId;
+        }
+        return Parent.find(key);
+    }
+
+    /**
+     * @brief
+     *  Maps a key to a set identifier in `Parent`, or in the map of
+     *  `worker` if it is not `nullptr`.
+     *
+     * @see     Parent, WorkerTy
+     **/
+    void assignParent(uint64_t key, int setId, WorkerTy *worker) {
+        if(worker) worker->Parent.assign(key, setId);
+        else Parent.assign(key, setId);
+    }
+
+    /**
+     * @brief
+     *  Renumbers the set identifiers in use and drops the `Parent`
+     *  entries which can no longer be looked up.
+     *
+     * @details
+     *  Set identifiers are never reused, so one which is in no 
+     *  partition can come back only as the value of a `Parent` entry
+     *  whose operands are in use. The set identifiers in use are thus
+     *  those in the partitions, along with the values of the entries
+     *  whose operands are in use, and the other entries are dropped.
+     *  The set identifiers in use are numbered from 0 in their old
+     *  order, keeping the storage shared by the partitions.
+     *
+     * @note    Must not be called while a wavefront is being solved.
+     *
+     * @returns     Void
+     *
+     * @see     maybeCompact, Parent, Partition::remap, SetCnt
+     **/
+    void compact() {
+        std::vector<Partition *> partitions;
+        for(auto &partition : Partitions)
+            partitions.push_back(&partition);
+
+        std::vector<int> newId(SetCnt, -1);
+        Partition::forEachEntry(partitions, [&](int setId) {
+            if(setId >= 0) newId[setId] = 0;
+        });
+
+        // the value of an entry can itself be an operand of another
+        // entry, so this is repeated until nothing more is found
+        for(bool found = true; found; ) {
+            found = false;
+            Parent.forEach([&](uint64_t key, int setId) {
+                if(newId[keyLeft(key)] == -1 or newId[keyRight(key)] == -1) return;
+                if(newId[setId] == -1) newId[setId] = 0, found = true;
+            });
+        }
+
+        int liveCnt = 0;
+        for(auto &setId : newId)
+            if(setId != -1) setId = liveCnt++;
+
+        FlatHashMap parent;
+        Parent.forEach([&](uint64_t key, int setId) {
+            int left = newId[keyLeft(key)], right = newId[keyRight(key)];
+            if(left != -1 and right != -1)
+                parent.assign(packKey(keyOp(key), left, right), newId[setId]);
+        });
+        Parent = std::move(parent);
+
+        Partition::remap(partitions, [&](int setId) {
+            return setId < 0 ? setId : newId[setId];
+        });
+
+        for(auto &labels : CanonicalLabel)
+            labels.clear(), labels.shrink_to_fit();
+        SetCnt = LiveSetCnt = liveCnt;
+    }
+
+    /**
+     * @brief   Compacts the set identifiers if enough have been created.
+     *
+     * @returns     Void
+     *
+     * @see     CompactThreshold, compact
+     **/
+    void maybeCompact() {
+        if(CompactThreshold > 0 and SetCnt >= std::max(CompactThreshold, 2 * LiveSetCnt)) {
+            // the partitions are copied and `Parent` is built again
+            // before the old ones are freed
+            if(MemoryBudget != 0)
+                checkMemoryBudget("compact", Partition::memoryUsage(Partitions) + Parent.memoryUsage());
+            compact();
+        }
+    }
+
+    /**
+     * @brief Checks whether two partitions are same.
+     * 
+     * @details
+     *  Two partitions are same if in the vectors representing
+     *  them values at two indexes are equal in the first 
+     *  vector iff they are equal in the second vector.
+     *  Both the vectors are relabelled on the fly to canonical 
+     *  form, where set identifiers are renumbered in the order 
+     *  of their first occurrence, and the partitions are same 
+     *  iff their canonical forms are equal. This takes a single 
+     *  pass and does not allocate once `CanonicalLabel` has grown 
+     *  to `SetCnt` entries.
+     * 
+     * @param[in]   first   First partition
+     * @param[in]   second  Second partition
+     * @param[in]   worker  Worker whose scratch space is used, 
+     *                      `nullptr` for that of the context
+     * @return      Returns  true if the two partitions are same,
+     *              otherwise false
+     * 
+     * @see     CanonicalLabel, Indexer, Partitions
+     **/
+    bool samePartition(Partition const &first, Partition const &second,
+                       WorkerTy *worker = nullptr) {
+        // partitions sharing all their storage are equal
+        if(first.sameStorage(second)) return true;
+
+        // a TOP partition is only same as another TOP partition
+        bool firstTop = (first[0] == -1), secondTop = (second[0] == -1);
+        if(firstTop or secondTop) return firstTop == secondTop;
+
+        std::vector<std::pair<int, int>> *canonicalLabel = CanonicalLabel;
+        int *canonicalStamp = &CanonicalStamp, setCnt = SetCnt;
+        if(worker) {
+            canonicalLabel = worker->CanonicalLabel;
+            canonicalStamp = &worker->CanonicalStamp, setCnt = worker->SetCnt;
+        }
+
+        for(int k = 0; k < 2; k++)
+            if((int)canonicalLabel[k].size() < setCnt) canonicalLabel[k].resize(setCnt, {0, 0});
+        int stamp = ++*canonicalStamp;
+
+        // next canonical label to be given in each partition
+        int nextLabel[2] = {0, 0};
+
+        for(int i = 0; i < (int)first.size(); i++) {
+            int setId[2] = {first[i], second[i]};
+
+            for(int k = 0; k < 2; k++) {
+                std::pair<int, int> &label = canonicalLabel[k][setId[k]];
+                if(label.first != stamp)
+                    label = {stamp, nextLabel[k]++};
+            }
+
+            if(canonicalLabel[0][setId[0]].second != canonicalLabel[1][setId[1]].second)
+                return false;
+        }
+
+        // the partitions are equivalent, so return `true`
+        return true;
+    }
+
+    /**
+     * @brief 
+     *  return  set identifier for a given two length expression 
+     *  at a program point.
+     * 
+     * @details
+     *  With the help of `Parent` map, first a check is made if 
+     *  a set identifier representing the expression at the
+     *  current program point exists. If so it is returned else
+     *  a new set identifier is created by updating `SetCnt` which
+     *  is returned. This information is also stored in the 
+     *  `Parent` map for future use.
+     * 
+     * @param[in]   partition   Vector representing the partition 
+     *                          at the program point.
+     * @param[in]   expIdx      Index of the expression whose set
+     *                          identifier is required at the
+     *                          program point.
+     * @param[in]   worker      Worker solving the program point in
+     *                          wavefront mode, otherwise `nullptr`.
+     * @return      The set identifier for the expression at the 
+     *              program point.
+     * 
+     * @note    Make sure that the second argument passed represents a 
+     *          length two expression.
+     * 
+     * @see     Indexer, Parent, Partitions, SetCnt, WorkerTy
+     **/
+    int findSet(Partition const &partition, int expIdx, WorkerTy *worker = nullptr) {
+        // set identifier corresponding to left and right 
+        // subexpressions at the current program point
+        int leftSetId = partition[Indexer.leftIndex(expIdx)];
+        int rightSetId = partition[Indexer.rightIndex(expIdx)];
+
+        // if a set representing the expression already exists
+        // return its identifier, otherwise return new set 
+        // identifier and update `Parent` map with this information
+        uint64_t key = packKey(Indexer.op(expIdx), leftSetId, rightSetId);
+        if(not worker) {
+            std::pair<int, bool> ret = Parent.insert(key, SetCnt);
+            if(ret.second) SetCnt++;
+            HERBRAND_STAT(ret.second ? Stats.FindSetMisses++ : Stats.FindSetHits++);
+            return ret.first;
+        }
+
+        // a worker records the key for which it creates a set 
+        // identifier, see `commitWorker`
+        int setId = findParent(key, worker);
+        HERBRAND_STAT(setId == -1 ? worker->FindSetMisses++ : worker->FindSetHits++);
+        if(setId == -1) {
+            setId = allocSetId(worker);
+            worker->Origin.back() = key;
+            worker->Parent.assign(key, setId);
+        }
+        return setId;
+    }
+
+    /**
+     * @brief Finds initial partition.
+     * 
+     * @details
+     *  Returns a vector representing initial partition
+     *  in which all expressions are in different 
+     *  partition (has non-equivalent set identifiers).
+     *  It also updates `Parent` map for identifiers
+     *  assigned to length two expressions.
+     * 
+     * @param[out]  partition   Vector to store the 
+     *                          initial partition.
+     * @return      Void
+     * 
+     * @see findSet, Indexer, Partitions
+     **/
+    void findInitialPartition(Partition &partition) {
+        // initialise partition
+        partition.assign(Indexer.size(), -1);
+
+        // create new IDstruct object for each epxression.
+        // For length two expressions this is done indirectly
+        // by calling `findSet` function which also updates
+        // `Parent` map
+        for(int i = 0; i < Indexer.size(); i++) {
+            if(Indexer.isValue(i)) partition.set(i, SetCnt++);
+            else partition.set(i, findSet(partition, i));
+        }
+    }
+
+    /**
+     * @brief
+     *  Returns equivalence class of an expression at a 
+     *  given program point.
+     * 
+     * @details
+     *  The equivalence class is the set of indexes corresponding
+     *  to the expressions (as given by `Indexer`) which have 
+     *  same set identifiers as the index representing the expression 
+     *  (passed as parameter).
+     *  
+     *
+     * @param[in]   partition   Vector representing the partition
+     *                          at current program point.
+     * @param[in]   expIdx      Index of expression whose equivalence
+     *                          class is required.
+     * @param[out]  expClass    Set containing identifiers corresponding
+     *                          to the required equivalence class.
+     * @return      Void
+     * 
+     * @see Indexer, Partitions
+     **/
+    void getClass(Partition const &partition, int expIdx, std::set<int> &expClass) {
+        expClass.clear();
+        int expSetId = partition[expIdx];
+        HERBRAND_STAT(Stats.GetClassCalls++, Stats.GetClassScanned += Indexer.size());
+
+        for(int i = 0; i < Indexer.size(); i++) {
+            if(expSetId == partition[i])
+                expClass.insert(i);
+        }
+    }
+
+    /**
+     * @brief Prints a partition in readable format.
+     * 
+     * @param[in]   partition   The partition vector to 
+     *                          be printed.
+     * @param[in]   os          Output stream to print to.
+     * @return      Void
+     * 
+     * @see Indexer, Partitions
+     **/
+    void printPartition(Partition const &partition, std::ostream &os) {
+        // if any index stores -1, then the whole vector
+        // stores -1, representing the TOP element
+        if(partition[0] == -1) {
+            os << "<TOP ELEMENT>";
+            return;    
+        }
+
+        // sorting the expressions by their set identifiers brings
+        // each equivalence class together, in the order of indexes
+        std::vector<std::pair<int, int>> entries(Indexer.size());
+        for(int i = 0; i < Indexer.size(); i++)
+            entries[i] = {partition[i], i};
+        std::sort(entries.begin(), entries.end());
+
+        // print the equivalence classes along with their
+        // set identifiers
+        CustomOStream exprOut(program, os);
+        for(int k = 0; k < (int)entries.size(); k++) {
+            int setId = entries[k].first;
+            if(k == 0 or entries[k - 1].first != setId) os << '[' << setId << "]{";
+            else os << ", ";
+
+            exprOut << Indexer.expression(entries[k].second);
+
+            if(k + 1 == (int)entries.size() or entries[k + 1].first != setId) os << "}, ";
+        }
+    }
+
+    /**
+     * @brief Prints a partition in readable format to `Out`.
+     **/
+    void printPartition(Partition const &partition) { printPartition(partition, Out); }
+
+    /**
+     * @brief Transfer function associated with Herbrand analysis.
+     * 
+     * @param[in]   cfgIndex    Control flow graph node index on 
+     *                          which transfer function is applied.
+     *                          The function modifies 
+     *                          `Partitions[cfgIndex]`.
+     * @param[in]   worker      Worker solving the node in wavefront
+     *                          mode, otherwise `nullptr`.
+     * @returns     Void
+     * 
+     * @see findSet, Indexer, Partitions, Program
+     **/
+    void transferFunction(int cfgIndex, WorkerTy *worker = nullptr) {
+        // current partition vector
+        Partition &partition = Partitions[cfgIndex];
+
+        // first copy predecessor partition into current partition,
+        // which shares its storage until modified below
+        partition = Partitions[program.CFG[cfgIndex].predecessors[0]];
+
+        // if the current partition has any index with value -1, it 
+        // means that it represents the TOP element and it has to be
+        // left as such without any modifications
+        if(partition[0] == -1) return;
+
+        // if the node is the END CFG node, return
+        int instIdx = program.CFG[cfgIndex].instructionIndex;
+        if(instIdx == (int)program.Instructions.size() - 1) return;
+
+        // `changedExp` is expression (ie. a constant or a variable) 
+        // which has been assigned value and `changedToExp` is the 
+        // expression which has been assigned to it
+        Program::InstructionTy &inst = program.Instructions[instIdx];
+        Program::ExpressionTy changedExp = {'\0', inst.lValue, NULL_VAL};
+        Program::ExpressionTy changedToExp = inst.rValue;
+
+        int changedIdx = Indexer.index(changedExp);
+
+        if(changedToExp.op == '#') {
+            // if it is a non-deterministic assignment, then create a
+            // new set identifier
+            partition.set(changedIdx, allocSetId(worker));
+        } else {
+            // assign the `changedExp`, the set identifier of 
+            // `changedToExp`
+            partition.set(changedIdx, partition[Indexer.index(changedToExp)]);
+        }
+
+        // update set identifiers for two length expressions 
+        // involving `changedExp`, set identifiers of all other
+        // expressions remain the same
+        for(auto el : UsedBy[changedIdx])
+            partition.set(el, findSet(partition, el, worker));
+    }
+
+    /**
+     * @brief
+     *  Updates `Parent` at a confluence point for the length two
+     *  expressions not tracked in sparse mode.
+     * 
+     * @details
+     *  Without sparse mode every length two expression `l op r` gets
+     *  a set identifier from the tuple of its set identifiers across
+     *  the predecessors, which is then recorded in `Parent`. Here the
+     *  same is done for each operator and each pair of classes of
+     *  constants and variables, reading the tuple from `Parent` (a
+     *  key missing there stands for a class of its own). A class is
+     *  recorded only if it is not fresh, ie. if it is same in all the
+     *  predecessors, is the class of a tracked expression or is shared
+     *  by more than one such pair. A fresh class is left to `findSet`
+     *  to create when needed.
+     * 
+     * @param[in]   partition       Partition at the confluence point,
+     *                              already computed for the tracked
+     *                              expressions.
+     * @param[in]   predPartitions  Partitions of the predecessors which
+     *                              are not TOP.
+     * @param[in]   newSetId        Set identifiers given to the tuples 
+     *                              of the tracked expressions.
+     * @param[in]   worker          Worker solving the confluence point
+     *                              in wavefront mode, otherwise 
+     *                              `nullptr`.
+     * @return      Hash describing the classes recorded, in terms of 
+     *              the partition at the confluence point.
+     * 
+     * @see confluenceFunction, ClosureSignature, SparseMode
+     **/
+    uint64_t confluenceClosure(Partition const &partition,
+                               std::vector<Partition const *> const &predPartitions,
+                               std::unordered_map<std::vector<int>, int, SetIdTupleHash> const &newSetId,
+                               WorkerTy *worker) {
+        // a tuple element for a key missing in `Parent`, set identifiers
+        // never have the highest bit set
+        const uint64_t missingBit = 1ULL << 63;
+
+        // classes by their tuples, starting with those of the tracked
+        // expressions. A class seen once so far has no set identifier
+        // and keeps the key and position of the pair which formed it.
+        // The tuples are stored one after another in `groupTuples` and
+        // looked up by their hash in `groupIndex`, probing the next
+        // hash on a collision
+        struct GroupTy { int setId; uint64_t firstKey; int firstPair; };
+        std::vector<GroupTy> groups;
+        std::vector<uint64_t> groupTuples;
+        FlatHashMap groupIndex;
+        int tupSize = predPartitions.size();
+
+        // returns the class of a tuple and whether it is new, adding
+        // `group` as its class if so
+        auto findGroup = [&](std::vector<uint64_t> const &tup, GroupTy group) {
+            uint64_t hash = SetIdTupleHash()(tup) & ~missingBit;
+            while(true) {
+                std::pair<int, bool> ret = groupIndex.insert(hash, groups.size());
+                if(ret.second) {
+                    groups.push_back(group);
+                    groupTuples.insert(groupTuples.end(), tup.begin(), tup.end());
+                    return ret;
+                }
+
+                auto it = groupTuples.begin() + (size_t)ret.first * tupSize;
+                if(std::equal(tup.begin(), tup.end(), it)) return ret;
+                hash = (hash + 1) & ~missingBit;
+            }
+        };
+
+        for(auto &el : newSetId) {
+            GroupTy group = {el.second, 0, -1};
+            findGroup(std::vector<uint64_t>(el.first.begin(), el.first.end()), group);
+        }
+
+        // canonical labels of set identifiers in order of their first 
+        // occurrence, and a representative for each class of constants
+        // and variables
+        std::unordered_map<int, int> label;
+        auto getLabel = [&](int setId) {
+            return label.emplace(setId, (int)label.size()).first->second;
+        };
+
+        std::vector<int> reps;
+        for(int i = 0; i < Indexer.size(); i++) {
+            bool seen = label.count(partition[i]);
+            getLabel(partition[i]);
+            if(not seen and Indexer.isValue(i)) reps.push_back(i);
+        }
+
+        uint64_t signature = 0xcbf29ce484222325ULL;
+        auto mix = [&](int val) { signature = (signature ^ (uint32_t)val) * 0x100000001b3ULL; };
+
+        std::vector<uint64_t> tup(predPartitions.size());
+        int pairCtr = 0;
+
+        for(auto op : Indexer.ops())
+            for(auto left : reps)
+                for(auto right : reps) {
+                    bool same = true;
+                    for(int j = 0; j < (int)tup.size(); j++) {
+                        Partition const &pred = *predPartitions[j];
+                        uint64_t predKey = packKey(op, pred[left], pred[right]);
+                        int setId = findParent(predKey, worker);
+
+                        tup[j] = (setId == -1 ? predKey | missingBit : setId);
+                        same &= (tup[j] == tup[0]);
+                    }
+
+                    uint64_t key = packKey(op, partition[left], partition[right]);
+                    int setId = -1;
+
+                    if(same and not (tup[0] & missingBit)) setId = tup[0];
+                    else {
+                        std::pair<int, bool> ret = findGroup(tup, GroupTy{-1, key, pairCtr});
+                        if(not ret.second) {
+                            GroupTy &group = groups[ret.first];
+                            if(group.setId == -1) {
+                                // second pair of a class, which now needs 
+                                // a set identifier for both the pairs
+                                group.setId = allocSetId(worker);
+                                assignParent(group.firstKey, group.setId, worker);
+                                mix(-2), mix(group.firstPair);
+                            }
+                            setId = group.setId;
+                        }
+                    }
+
+                    if(setId != -1) assignParent(key, setId, worker), mix(getLabel(setId));
+                    else mix(-1);
+                    pairCtr++;
+                }
+
+        return signature;
+    }
+
+    /**
+     * @brief Confluence function associated with Herbrand analysis.
+     * 
+     * @param[in]   cfgIndex    Control flow graph node index on 
+     *                          which confluence function is applied.
+     * @param[in]   worker      Worker solving the node in wavefront
+     *                          mode, otherwise `nullptr`.
+     * @returns     Void
+     * 
+     * @see findSet, Indexer, Partitions, Program
+     **/
+    void confluenceFunction(int cfgIndex, WorkerTy *worker = nullptr) {
+        // vector of  predecessor CFG node indexes
+        std::vector<int> &predecessors = program.CFG[cfgIndex].predecessors;
+
+        // if all the predecessors partition represents TOP 
+        // element then their confluence is also TOP element.
+        // So, the current partition need not be modified as
+        // by initialisation the current partition is also the
+        // TOP element
+        bool cont = false;
+        for(auto pred : predecessors)
+            cont |= (Partitions[pred][0] != -1);
+        if(not cont) return;
+
+        // the current partition
+        Partition &partition = Partitions[cfgIndex];
+
+        // predecessors whose partitions are not TOP, the TOP
+        // partitions do not affect the confluence
+        std::vector<Partition const *> predPartitions;
+        for(auto pred : predecessors)
+            if(Partitions[pred][0] != -1)
+                predPartitions.push_back(&Partitions[pred]);
+
+        // two expressions are equivalent at the confluence point iff
+        // they are equivalent in all the predecessors, ie. iff they 
+        // have the same tuple of set identifiers across the
+        // predecessors. `newSetId` maps each such tuple to the set 
+        // identifier assigned to it
+        std::unordered_map<std::vector<int>, int, SetIdTupleHash> newSetId;
+        std::vector<int> tup(predPartitions.size());
+
+        // process all the expressions one by one. If the set 
+        // identifier for the expression in all the predecessors 
+        // is same it is assigned the same set identifier; else
+        // the set identifier for its tuple is assigned, creating
+        // a new one if this tuple is seen for the first time
+        for(int i = 0; i < Indexer.size(); i++) {
+            // a leaf shared by all the predecessors holds the same set
+            // identifiers in all of them, so it is shared as a whole
+            if(i % Partition::LeafSize == 0) {
+                bool shared = true;
+                for(auto pred : predPartitions)
+                    shared &= pred->sameLeaf(*predPartitions[0], i);
+
+                if(shared) {
+                    partition.shareLeaf(*predPartitions[0], i);
+                    i += Partition::LeafSize - 1;
+                    continue;
+                }
+            }
+
+            bool same = true;
+            for(int j = 0; j < (int)tup.size(); j++) {
+                tup[j] = (*predPartitions[j])[i];
+                same &= (tup[j] == tup[0]);
+            }
+
+            if(same) {
+                partition.set(i, tup[0]);
+                continue;
+            }
+
+            auto it = newSetId.find(tup);
+            if(it == newSetId.end()) it = newSetId.emplace(tup, allocSetId(worker)).first;
+            partition.set(i, it->second);
+        }
+
+        // now update `Parent` map
+        for(int i = Indexer.numValues(); i < Indexer.size(); i++) {
+            int leftSetId = partition[Indexer.leftIndex(i)];
+            int rightSetId = partition[Indexer.rightIndex(i)];
+
+            assignParent(packKey(Indexer.op(i), leftSetId, rightSetId), partition[i], worker);
+        }
+
+        // and the untracked expressions in sparse mode
+        if(SparseMode)
+            ClosureSignature[cfgIndex] = confluenceClosure(partition, predPartitions, newSetId, worker);
+    }
+
+    /**
+     * @brief
+     *  Finds the order in which CFG nodes are taken out of
+     *  the worklist of their strongly connected component.
+     *
+     * @details
+     *  Each node gets a priority key `{-loopDepth, rpoNumber}`,
+     *  where `rpoNumber` is its position in the reverse postorder
+     *  of a depth first search from START and `loopDepth` is the
+     *  number of natural loops containing it. Smaller keys are
+     *  processed first, so inner loops converge before outer ones
+     *  and within a loop nest nodes are visited in reverse
+     *  postorder.
+     *
+     * @param[out]  priority    Priority key of each CFG node.
+     * @return      Void
+     *
+     * @see HerbrandEquivalence, Program::CFG
+     **/
+    void findWorklistOrder(std::vector<std::pair<int, int>> &priority) {
+        int cfgSize = program.CFG.size();
+
+        // iterative depth first search from START. `onStack` marks
+        // the nodes on the current DFS path, an edge into such a
+        // node is a back edge
+        std::vector<int> postorder, nextSucc(cfgSize, 0);
+        std::vector<bool> visited(cfgSize, false), onStack(cfgSize, false);
+        std::vector<std::pair<int, int>> backEdges;
+        std::vector<int> stk({0});
+        visited[0] = onStack[0] = true;
+
+        while(not stk.empty()) {
+            int cur = stk.back();
+            std::vector<int> &succs = program.CFG[cur].successors;
+
+            if(nextSucc[cur] == (int)succs.size()) {
+                onStack[cur] = false;
+                postorder.push_back(cur), stk.pop_back();
+                continue;
+            }
+
+            int succ = succs[nextSucc[cur]++];
+            if(onStack[succ]) backEdges.push_back({cur, succ});
+            else if(not visited[succ]) {
+                visited[succ] = onStack[succ] = true;
+                stk.push_back(succ);
+            }
+        }
+
+        // collect the natural loop of each back edge `latch -> header`
+        // by walking predecessors from the latch until the header. Back
+        // edges to the same header form a single loop
+        std::map<int, std::set<int>> loops;
+        for(auto &edge : backEdges) {
+            std::set<int> &body = loops[edge.second];
+            body.insert(edge.second);
+
+            std::vector<int> work;
+            if(body.insert(edge.first).second) work.push_back(edge.first);
+            while(not work.empty()) {
+                int cur = work.back();
+                work.pop_back();
+                for(auto pred : program.CFG[cur].predecessors)
+                    if(body.insert(pred).second) work.push_back(pred);
+            }
+        }
+
+        std::vector<int> loopDepth(cfgSize, 0);
+        for(auto &loop : loops)
+            for(auto el : loop.second) loopDepth[el]++;
+
+        priority.assign(cfgSize, {0, 0});
+        for(int i = 0; i < cfgSize; i++) {
+            int node = postorder[cfgSize - 1 - i];
+            priority[node] = {-loopDepth[node], i};
+        }
+    }
+
+    /**
+     * @brief
+     *  Applies the transfer or confluence function at a CFG node
+     *  and returns whether its successors need to be processed 
+     *  again.
+     *
+     * @details
+     *  Successors need to be processed again only if the partition
+     *  at the node has changed. In sparse mode a change in the
+     *  untracked expressions is seen only at confluence points, so
+     *  a transfer point always passes on the change which caused it
+     *  to be processed.
+     *
+     * @param[in]   cfgIndex    Control flow graph node index.
+     * @param[out]  counters    Counters updated for the node.
+     * @param[in]   worker      Worker solving the node in wavefront
+     *                          mode, otherwise `nullptr`.
+     * @return      True if the successors are to be processed again
+     *              otherwise false
+     *
+     * @see confluenceFunction, samePartition, transferFunction
+     **/
+    bool processNode(int cfgIndex, CountersTy &counters, WorkerTy *worker = nullptr) {
+        counters.Iterations++;
+
+        // partition at the node before applying transfer/confluence
+        // function, sharing its storage
+        Partition oldPartition = Partitions[cfgIndex];
+        uint64_t oldSignature = ClosureSignature[cfgIndex];
+
+        bool isConfluence = (program.CFG[cfgIndex].predecessors.size() > 1);
+        if(isConfluence) confluenceFunction(cfgIndex, worker), counters.Confluences++;
+        else transferFunction(cfgIndex, worker), counters.Transfers++;
+
+        bool changed = not samePartition(oldPartition, Partitions[cfgIndex], worker);
+        if(SparseMode) {
+            if(isConfluence) changed |= (ClosureSignature[cfgIndex] != oldSignature);
+            else changed = true;
+        }
+
+        // a worker's set identifiers are provisional, so `SetCnt` is
+        // sampled once they are committed
+        HERBRAND_STAT(isConfluence ? Stats.NodeConfluences[cfgIndex]++ : Stats.NodeTransfers[cfgIndex]++);
+        HERBRAND_STAT(if(not worker) Stats.sampleSetCnt(counters.Iterations, SetCnt));
+
+        // workers leave the checks to the thread committing them
+        if(not worker and MemoryBudget != 0 and counters.Iterations % MemoryCheckInterval == 0)
+            checkMemoryBudget("fixpoint");
+        return changed;
+    }
+
+    /**
+     * @brief
+     *  Finds the strongly connected components of the control flow
+     *  graph.
+     *
+     * @details
+     *  Uses an iterative version of Tarjan's algorithm, which finds
+     *  a component only after all the components reachable from it,
+     *  so the components are reversed at the end.
+     *
+     * @param[out]  components  Nodes of each component, the components
+     *                          in topological order.
+     * @param[out]  componentOf Component of each node.
+     * @return      Void
+     *
+     * @see solveWavefront, Program::CFG
+     **/
+    void findComponents(std::vector<std::vector<int>> &components,
+                        std::vector<int> &componentOf) {
+        int cfgSize = program.CFG.size();
+        std::vector<int> order(cfgSize, -1), low(cfgSize, 0), nextSucc(cfgSize, 0);
+        std::vector<bool> onStack(cfgSize, false);
+        std::vector<int> nodeStack, dfsStack;
+        int orderCtr = 0;
+
+        components.clear();
+        componentOf.assign(cfgSize, -1);
+
+        for(int root = 0; root < cfgSize; root++) {
+            if(order[root] != -1) continue;
+
+            dfsStack.push_back(root);
+            while(not dfsStack.empty()) {
+                int cur = dfsStack.back();
+                if(nextSucc[cur] == 0 and order[cur] == -1) {
+                    order[cur] = low[cur] = orderCtr++;
+                    nodeStack.push_back(cur), onStack[cur] = true;
+                }
+
+                std::vector<int> &succs = program.CFG[cur].successors;
+                if(nextSucc[cur] < (int)succs.size()) {
+                    int succ = succs[nextSucc[cur]++];
+                    if(order[succ] == -1) dfsStack.push_back(succ);
+                    else if(onStack[succ]) low[cur] = std::min(low[cur], order[succ]);
+                    continue;
+                }
+
+                // all the successors are done, `cur` is the root of a 
+                // component iff no node on the stack above it reaches
+                // a node below it
+                dfsStack.pop_back();
+                if(not dfsStack.empty())
+                    low[dfsStack.back()] = std::min(low[dfsStack.back()], low[cur]);
+                if(low[cur] != order[cur]) continue;
+
+                components.emplace_back();
+                while(true) {
+                    int node = nodeStack.back();
+                    nodeStack.pop_back(), onStack[node] = false;
+                    components.back().push_back(node);
+                    if(node == cur) break;
+                }
+            }
+        }
+
+        std::reverse(components.begin(), components.end());
+        for(int c = 0; c < (int)components.size(); c++)
+            for(auto node : components[c]) componentOf[node] = c;
+    }
+
+    /**
+     * @brief
+     *  Finds the strongly connected components of the control flow
+     *  graph in topological order, with the nodes of each component
+     *  in the order of their priority.
+     *
+     * @param[in]   priority    Priority key of each CFG node.
+     * @param[out]  components  Nodes of each component.
+     * @param[out]  componentOf Component of each node.
+     * @param[out]  localIndex  Position of each node in the nodes of
+     *                          its component.
+     * @return      Void
+     *
+     * @see findComponents, findWorklistOrder
+     **/
+    void orderComponents(std::vector<std::pair<int, int>> const &priority,
+                         std::vector<std::vector<int>> &components,
+                         std::vector<int> &componentOf, std::vector<int> &localIndex) {
+        findComponents(components, componentOf);
+
+        localIndex.assign(program.CFG.size(), 0);
+        for(auto &nodes : components) {
+            std::sort(nodes.begin(), nodes.end(),
+                      [&](int a, int b) { return priority[a] < priority[b]; });
+            for(int i = 0; i < (int)nodes.size(); i++)
+                localIndex[nodes[i]] = i;
+        }
+    }
+
+    /**
+     * @brief
+     *  Computes the fixpoint of a strongly connected component with
+     *  a worklist local to it, once the components before it are
+     *  solved.
+     *
+     * @details
+     *  Initially the nodes of the component with a predecessor in an
+     *  earlier component are in the worklist, so a node outside any
+     *  loop is processed exactly once. Only the successors in the 
+     *  same component are added to the worklist, and they are taken
+     *  out in the order of their priority, so an inner loop is 
+     *  iterated until it is stable before the rest of its outer loop
+     *  is processed again.
+     *
+     * @param[in]   nodes       Nodes of the component, in the order of
+     *                          their priority.
+     * @param[in]   componentOf Component of each node.
+     * @param[in]   localIndex  Position of each node in the nodes of
+     *                          its component.
+     * @param[out]  counters    Counters updated for the nodes.
+     * @param[in]   worker      Worker solving the component in wavefront
+     *                          mode, otherwise `nullptr`. Without a 
+     *                          worker each node is printed as it is
+     *                          processed, as per `Verbosity`, and the
+     *                          set identifiers are compacted when 
+     *                          needed.
+     * @return      Void
+     *
+     * @see processNode, solveComponents, solveWavefront
+     **/
+    void solveComponent(std::vector<int> const &nodes, std::vector<int> const &componentOf,
+                        std::vector<int> const &localIndex, CountersTy &counters,
+                        WorkerTy *worker = nullptr) {
+        std::set<int> worklist;
+        for(int i = 0; i < (int)nodes.size(); i++)
+            for(auto pred : program.CFG[nodes[i]].predecessors)
+                if(componentOf[pred] != componentOf[nodes[i]]) {
+                    worklist.insert(i);
+                    break;
+                }
+
+        while(not worklist.empty()) {
+            int node = nodes[*worklist.begin()];
+            worklist.erase(worklist.begin());
+
+            bool changed = processNode(node, counters, worker);
+            if(not worker) {
+                if(Verbosity == TRACE) printNode(node);
+                else if(Verbosity == SUMMARY) printSummary(node, changed);
+                maybeCompact();
+            }
+
+            if(not changed) continue;
+            for(auto succ : program.CFG[node].successors)
+                if(componentOf[succ] == componentOf[node])
+                    worklist.insert(localIndex[succ]);
+        }
+    }
+
+    /**
+     * @brief
+     *  Computes the fixpoint by solving the strongly connected
+     *  components of the control flow graph one after another, in
+     *  topological order.
+     *
+     * @details
+     *  All the predecessors of a component outside it are in earlier
+     *  components, so their partitions are final once the component
+     *  is reached. A node outside any loop is thus processed exactly
+     *  once, and a loop is iterated only until it is stable, without
+     *  processing the nodes after it again.
+     *
+     * @param[in]   priority    Priority key of each CFG node.
+     * @param[out]  counters    Counters updated for the nodes.
+     * @param[in]   affected    Nodes to be solved, all the nodes if it
+     *                          is `nullptr`. The other nodes must hold
+     *                          their partitions on convergence already,
+     *                          and a component is either solved 
+     *                          completely or not at all.
+     * @return      Void
+     *
+     * @see editInstruction, orderComponents, solveComponent
+     **/
+    void solveComponents(std::vector<std::pair<int, int>> const &priority,
+                         CountersTy &counters, std::vector<bool> const *affected = nullptr) {
+        std::vector<std::vector<int>> components;
+        std::vector<int> componentOf, localIndex;
+        orderComponents(priority, components, componentOf, localIndex);
+
+        for(auto &nodes : components) {
+            // START is solved already
+            if(nodes[0] == 0 or (affected and not (*affected)[nodes[0]])) continue;
+            solveComponent(nodes, componentOf, localIndex, counters);
+        }
+    }
+
+    /**
+     * @brief
+     *  Replaces the provisional set identifiers of a worker by set
+     *  identifiers of the context, and commits its `Parent` entries.
+     *
+     * @details
+     *  Provisional set identifiers get new set identifiers in the
+     *  order they were created, except that one created by `findSet`
+     *  for a key which is now in `Parent`, committed by an earlier
+     *  worker of the same wavefront, takes the set identifier there
+     *  as it would have if the components were solved one after
+     *  another. The partitions of the component and the entries of
+     *  the map of the worker are then rewritten. This depends only
+     *  on the worker and the order of the commits, not on the order
+     *  in which the workers ran.
+     *
+     * @param[in,out]   worker  Worker whose wavefront is solved.
+     * @return      Void
+     *
+     * @see solveWavefront, WorkerTy
+     **/
+    void commitWorker(WorkerTy &worker) {
+        std::vector<int> newId(worker.SetCnt - worker.Base);
+        auto translate = [&](int setId) {
+            return setId < worker.Base ? setId : newId[setId - worker.Base];
+        };
+        auto translateKey = [&](uint64_t key) {
+            return packKey(keyOp(key), translate(keyLeft(key)), translate(keyRight(key)));
+        };
+
+        // the operands of a key are created before the set identifier
+        // created for it, so they are translated already
+        for(int i = 0; i < (int)newId.size(); i++) {
+            int setId = -1;
+            if(worker.Origin[i] != ~0ULL) setId = Parent.find(translateKey(worker.Origin[i]));
+            newId[i] = (setId != -1 ? setId : SetCnt++);
+        }
+
+        worker.Parent.forEach([&](uint64_t key, int setId) {
+            Parent.assign(translateKey(key), translate(setId));
+        });
+
+        for(auto node : worker.Nodes) {
+            Partition &partition = Partitions[node];
+            if(partition[0] == -1) continue;
+
+            for(int i = 0; i < partition.size(); i++)
+                if(partition[i] >= worker.Base) partition.set(i, translate(partition[i]));
+        }
+    }
+
+    /**
+     * @brief
+     *  Computes the fixpoint by wavefronts of the strongly connected
+     *  components of the control flow graph.
+     *
+     * @details
+     *  The wavefront of a component is one more than the largest 
+     *  wavefront of the components with an edge into it, so there is
+     *  no path between two components of the same wavefront. All the
+     *  components of a wavefront are solved at the same time on 
+     *  `NumThreads` threads, each by its own worker, and then the
+     *  workers are committed in the topological order of their 
+     *  components. The result does not depend on the number of
+     *  threads.
+     *
+     * @param[in]   priority    Priority key of each CFG node.
+     * @param[out]  counters    Counters updated for the nodes.
+     * @return      Void
+     *
+     * @see commitWorker, findComponents, solveComponent
+     **/
+    void solveWavefront(std::vector<std::pair<int, int>> const &priority, CountersTy &counters) {
+        std::vector<std::vector<int>> components;
+        std::vector<int> componentOf, localIndex;
+        orderComponents(priority, components, componentOf, localIndex);
+
+        std::vector<int> wavefront(components.size(), 0);
+        std::vector<std::vector<int>> wavefronts;
+        for(int c = 0; c < (int)components.size(); c++) {
+            std::vector<int> &nodes = components[c];
+            for(auto node : nodes)
+                for(auto pred : program.CFG[node].predecessors)
+                    if(componentOf[pred] != c)
+                        wavefront[c] = std::max(wavefront[c], wavefront[componentOf[pred]] + 1);
+
+            // START is solved already
+            if(nodes[0] == 0) continue;
+            if((int)wavefronts.size() <= wavefront[c]) wavefronts.resize(wavefront[c] + 1);
+            wavefronts[wavefront[c]].push_back(c);
+        }
+
+        std::unique_ptr<ThreadPool> pool;
+        if(NumThreads > 1) pool.reset(new ThreadPool(NumThreads));
+
+        for(auto &wave : wavefronts) {
+            std::vector<WorkerTy> workers(wave.size());
+            for(int k = 0; k < (int)wave.size(); k++) {
+                workers[k].Nodes = components[wave[k]];
+                workers[k].Base = workers[k].SetCnt = SetCnt;
+            }
+
+            for(auto &worker : workers) {
+                WorkerTy *w = &worker;
+                if(pool) pool->submit([this, w, &componentOf, &localIndex] {
+                    solveComponent(w->Nodes, componentOf, localIndex, w->Counters, w);
+                });
+                else solveComponent(worker.Nodes, componentOf, localIndex, worker.Counters, &worker);
+            }
+            if(pool) pool->wait();
+
+            for(auto &worker : workers) {
+                commitWorker(worker);
+                counters.Iterations += worker.Counters.Iterations;
+                counters.Transfers += worker.Counters.Transfers;
+                counters.Confluences += worker.Counters.Confluences;
+                HERBRAND_STAT(Stats.FindSetHits += worker.FindSetHits,
+                              Stats.FindSetMisses += worker.FindSetMisses,
+                              Stats.sampleSetCnt(counters.Iterations, SetCnt));
+
+                if(Verbosity == TRACE) {
+                    for(auto node : worker.Nodes)
+                        printNode(node);
+                } else if(Verbosity == SUMMARY) {
+                    Out << "Component of [" << worker.Nodes[0] << "] : " 
+                        << worker.Nodes.size() << " nodes, " 
+                        << worker.Counters.Iterations << " iterations\n";
+                }
+            }
+            maybeCompact();
+            checkMemoryBudget("fixpoint");
+        }
+    }
+
+    /**
+     * @brief Prints a CFG node along with its partition.
+     *
+     * @param[in]   cfgIndex    Control flow graph node index.
+     * @param[in]   os          Output stream to print to.
+     * @return      Void
+     *
+     * @see printPartition, Program::CFG
+     **/
+    void printNode(int cfgIndex, std::ostream &os) {
+        std::vector<int> &predecessors = program.CFG[cfgIndex].predecessors;
+        int instIdx = program.CFG[cfgIndex].instructionIndex;
+
+        os << '[' << cfgIndex << "] : ";
+        if(predecessors.size() > 1) {
+            os << "Confluence of [ ";
+            for(auto el : predecessors)
+                os << el << " ";
+            os << "]\n\t";
+        } else {
+            CustomOStream exprOut(program, os);
+            if(instIdx != (int)program.Instructions.size() - 1) {
+                exprOut << "Transfer Point => (" << instIdx << ") "
+                        << program.Instructions[instIdx];
+            } else exprOut << "END";
+
+            exprOut << " [" << predecessors[0] << "]\n\t";
+        }
+
+        printPartition(Partitions[cfgIndex], os);
+        os << "\n\n";
+    }
+
+    /**
+     * @brief Prints a CFG node along with its partition to `Out`.
+     **/
+    void printNode(int cfgIndex) { printNode(cfgIndex, Out); }
+
+    /**
+     * @brief
+     *  Prints a line for a CFG node processed, at `SUMMARY`
+     *  verbosity.
+     *
+     * @param[in]   cfgIndex    Control flow graph node index.
+     * @param[in]   changed     Whether its successors are to be
+     *                          processed again.
+     * @return      Void
+     **/
+    void printSummary(int cfgIndex, bool changed) {
+        Out << '[' << cfgIndex << "] " << (changed ? "changed" : "unchanged") << '\n';
+    }
+
+    /**
+     * @brief Main Herbrand analysis function.
+     *
+     * @details
+     *  The fixpoint is computed by solving the strongly connected
+     *  components of the control flow graph in topological order,
+     *  or by wavefronts of them if `Wavefront` is set. Within a 
+     *  component nodes are processed in the order given by 
+     *  `findWorklistOrder`. What is printed is decided by 
+     *  `Verbosity`.
+     *
+     * @returns     Void
+     *
+     * @see findWorklistOrder, Partitions, Indexer, Parent, Program,
+     *      solveComponents, solveWavefront, Verbosity
+     **/
+    void HerbrandEquivalence() {
+        if(Verbosity != FINAL) {
+            PRINT_HEADER(Out, "Herbrand Equivalence Computation");
+            Out << "\n";
+        }
+
+        // assign index to expressions
+        assignIndex();
+        recordMemory("assignIndex");
+
+        // the result cached for the same program and options, if
+        // any, is used instead of computing the fixpoint. Above `FINAL`
+        // the fixpoint is computed anyway, for the nodes processed to
+        // be printed, and the result is cached again
+        std::string cacheFile;
+        uint64_t hash = 0;
+        if(not CacheDir.empty()) {
+            hash = inputHash(), cacheFile = ResultFormat::cacheFileName(CacheDir, hash);
+            if(Verbosity == FINAL and readResult(cacheFile, hash)) {
+                recordMemory("readResult");
+                printResult(Counters);
+                recordMemory("print");
+                return;
+            }
+        }
+
+        computeFixpoint();
+        recordMemory("fixpoint");
+
+        if(not cacheFile.empty() and not writeResult(cacheFile, hash))
+            std::cerr << "Could not write " << cacheFile << '\n';
+
+        printResult(Counters);
+        recordMemory("print");
+    }
+
+    /**
+     * @brief
+     *  Computes the fixpoint from the initial partition, once the
+     *  expressions are indexed.
+     *
+     * @details
+     *  Any set identifiers and `Parent` entries of an earlier
+     *  fixpoint are dropped first.
+     *
+     * @returns     Void
+     *
+     * @see Counters, findWorklistOrder, solveComponents, solveWavefront
+     **/
+    void computeFixpoint() {
+        HERBRAND_TIMER(timer, Stats, "fixpoint");
+        HERBRAND_STAT(Stats.startFixpoint(program.CFG.size()));
+        Parent.clear();
+        SetCnt = LiveSetCnt = 0;
+
+        // the partitions all share their storage to begin with, and
+        // are copied as they are modified
+        checkMemoryBudget("fixpoint",
+                          Partition::sharedMemoryUsage(Indexer.size(), program.CFG.size()));
+
+        // initialise partition vector with -1 for each program
+        // points and each expression - this stands for TOP 
+        // partition at each program point. Note that any element
+        // of partition vector being -1 means that whole vector
+        // holds -1 and represents TOP partition
+        Partitions.assign(program.CFG.size(), Partition(Indexer.size(), -1));
+        ClosureSignature.assign(program.CFG.size(), 0);
+
+        // initialise starting partition for START node
+        findInitialPartition(Partitions[0]);
+
+        if(Verbosity != FINAL) {
+            PRINT_HEADER(Out, "Initial Partition");
+            printPartition(Partitions[0]);
+            Out << "\n\n\n";
+
+            PRINT_HEADER(Out, "Iterations");
+        }
+
+        // priority of each node in the worklist of its component
+        std::vector<std::pair<int, int>> priority;
+        findWorklistOrder(priority);
+
+        Counters = CountersTy();
+        if(Wavefront) solveWavefront(priority, Counters);
+        else solveComponents(priority, Counters);
+    }
+
+    /**
+     * @brief
+     *  Checks whether an instruction can be replaced by
+     *  `editInstruction`, that is whether it is an instruction of the
+     *  program other than START and END.
+     *
+     * @param[in]   instIdx     Index of the instruction, as given by
+     *                          `Program::Instructions`.
+     * @return      True if the instruction can be replaced otherwise
+     *              false.
+     *
+     * @see editInstruction
+     **/
+    bool isEditable(int instIdx) const {
+        return instIdx >= 1 and instIdx <= (int)program.Instructions.size() - 2;
+    }
+
+    /**
+     * @brief
+     *  Replaces an instruction of the program once the fixpoint is
+     *  computed, and computes the fixpoint of the edited program.
+     *
+     * @details
+     *  Only the partitions at the nodes reachable from the node of
+     *  the instruction depend on it, so the other nodes keep their
+     *  partitions, and the nodes reachable from it are set to TOP and
+     *  solved again component by component from the edited node.
+     *  `Counters` then counts only these nodes. `Parent` is kept, as
+     *  its entries hold at every program point.
+     *
+     *  If the instruction uses a constant or variable new to the
+     *  program, or in sparse mode a length two expression which is
+     *  not tracked, the expressions are indexed again and the
+     *  fixpoint is computed from the initial partition.
+     *
+     *  START and END, the first and the last instructions, cannot
+     *  be edited. An `std::out_of_range` is thrown for them and for
+     *  any index outside `Program::Instructions`, and an
+     *  `std::invalid_argument` for a text which is not an
+     *  instruction (see `Program::checkInstruction`), before
+     *  anything is changed.
+     *
+     * @param[in]   instIdx     Index of the instruction, as given by
+     *                          `Program::Instructions`.
+     * @param[in]   text        Text of the new instruction, of the form
+     *                          accepted by `Program::parseInstruction`.
+     * @return      True if only the nodes reachable from the edited 
+     *              node were solved, false if the whole program was.
+     *
+     * @see computeFixpoint, isEditable, Program::checkInstruction,
+     *      Program::parseInstruction, solveComponents
+     **/
+    bool editInstruction(int instIdx, std::string const &text) {
+        if(not isEditable(instIdx))
+            throw std::out_of_range("Instruction index " + std::to_string(instIdx) +
+                                    " is not between 1 and " +
+                                    std::to_string((int)program.Instructions.size() - 2));
+        std::string error = Program::checkInstruction(text, Ops);
+        if(not error.empty())
+            throw std::invalid_argument("Instruction \"" + text + "\": " + error);
+        int constCnt = program.Constants.size(), varCnt = program.Variables.size();
+
+        Program::InstructionTy &inst = program.Instructions[instIdx];
+        Program::InstructionTy edited = program.parseInstruction(text);
+        inst.lValue = edited.lValue, inst.rValue = edited.rValue;
+
+        bool reindex = ((int)program.Constants.size() != constCnt or 
+                        (int)program.Variables.size() != varCnt);
+        if(SparseMode and inst.rValue.op != '\0' and inst.rValue.op != '#')
+            reindex |= (Indexer.index(inst.rValue) == -1);
+        if(reindex) {
+            assignIndex();
+            computeFixpoint();
+            return false;
+        }
+
+        // nodes reachable from the edited node, an unreachable
+        // instruction has no node
+        std::vector<bool> affected(program.CFG.size(), false);
+        std::vector<int> stack;
+        if(inst.reachable) stack.push_back(inst.cfgIndex), affected[inst.cfgIndex] = true;
+        while(not stack.empty()) {
+            int node = stack.back();
+            stack.pop_back();
+
+            Partitions[node].assign(Indexer.size(), -1);
+            ClosureSignature[node] = 0;
+            for(auto succ : program.CFG[node].successors)
+                if(not affected[succ]) affected[succ] = true, stack.push_back(succ);
+        }
+
+        std::vector<std::pair<int, int>> priority;
+        findWorklistOrder(priority);
+
+        HERBRAND_TIMER(timer, Stats, "fixpoint");
+        HERBRAND_STAT(Stats.startFixpoint(program.CFG.size()));
+        Counters = CountersTy();
+        solveComponents(priority, Counters, &affected);
+        return true;
+    }
+
+    /**
+     * @brief
+     *  Prints the number of nodes processed and the partition at 
+     *  each program point, once the fixpoint is computed.
+     *
+     * @details
+     *  The partitions are printed to a buffer, which is written to
+     *  `Out` in large blocks.
+     *
+     * @param[in]   counters    Nodes processed.
+     * @return      Void
+     **/
+    void printResult(CountersTy const &counters) {
+        HERBRAND_TIMER(timer, Stats, "print");
+        if(Verbosity != FINAL) Out << "\n\n";
+
+        PRINT_HEADER(Out, "Final Partitions");
+        Out << "Converged after " << counters.Iterations << " iterations ("
+            << counters.Transfers << " transfer, " << counters.Confluences
+            << " confluence)\n\n";
+
+        std::ostringstream buffer;
+        for(int i = 1; i < (int)program.CFG.size(); i++) {
+            printNode(i, buffer);
+            if(buffer.tellp() >= (1 << 20)) Out << buffer.str(), buffer.str("");
+        }
+        Out << buffer.str();
+    }
+
+    /**
+     * @brief
+     *  Saves the partition at each program point to a result file,
+     *  once the fixpoint is computed.
+     *
+     * @details
+     *  The program points are the nodes of the control flow graph,
+     *  in the order of their CFG indexes and labelled by their
+     *  instruction (or START, END or Confluence). The partition at
+     *  a node is stored relative to the one at its first
+     *  predecessor. `Parent`, `SetCnt` and `Counters` are saved
+     *  too, so that `readResult` can restore them.
+     *
+     * @param[in]   fname       Name of the file to be written.
+     * @param[in]   inputHash   Hash of the program, 0 if it is not
+     *                          known.
+     * @return      True if the file was written otherwise false.
+     *
+     * @see inputHash, ResultFile, writeResultFile
+     **/
+    bool writeResult(std::string const &fname, uint64_t inputHash = 0) {
+        ResultContentsTy contents;
+        std::vector<std::string> &expressions = contents.Expressions;
+        expressions.resize(Indexer.size());
+        for(int i = 0; i < Indexer.size(); i++) {
+            std::ostringstream text;
+            CustomOStream exprOut(program, text);
+            exprOut << Indexer.expression(i);
+            expressions[i] = text.str();
+        }
+
+        std::vector<std::string> &labels = contents.Labels;
+        std::vector<int> &bases = contents.Bases;
+        labels.resize(program.CFG.size()), bases.assign(program.CFG.size(), -1);
+        for(int i = 0; i < (int)program.CFG.size(); i++) {
+            auto &node = program.CFG[i];
+            int instIdx = node.instructionIndex;
+
+            std::ostringstream text;
+            CustomOStream exprOut(program, text);
+            if(node.predecessors.empty()) exprOut << "START";
+            else if(node.predecessors.size() > 1) exprOut << "Confluence";
+            else if(instIdx == (int)program.Instructions.size() - 1) exprOut << "END";
+            else exprOut << program.Instructions[instIdx];
+            labels[i] = text.str();
+
+            if(not node.predecessors.empty()) bases[i] = node.predecessors[0];
+        }
+
+        contents.Points = Partitions;
+        contents.InputHash = inputHash, contents.SetCnt = SetCnt;
+        Parent.forEach([&](uint64_t key, int setId) { contents.Parent.push_back({key, setId}); });
+        contents.Iterations = Counters.Iterations, contents.Transfers = Counters.Transfers;
+        contents.Confluences = Counters.Confluences;
+
+        return writeResultFile(fname, contents);
+    }
+
+    /**
+     * @brief
+     *  Restores the state of the analysis on convergence from a
+     *  result file written by `writeResult`.
+     *
+     * @details
+     *  The file is used only if it was written for a program with
+     *  the same hash and has as many expressions and program points
+     *  as this program. `Partitions`, `Parent`, `SetCnt` and 
+     *  `Counters` are then as they were when the file was written.
+     *
+     * @param[in]   fname       Name of the file.
+     * @param[in]   inputHash   Hash of the program.
+     * @return      True if the state was restored otherwise false.
+     *
+     * @see inputHash, ResultFile, writeResult
+     **/
+    bool readResult(std::string const &fname, uint64_t inputHash) {
+        ResultFile result;
+        if(not result.open(fname) or result.inputHash() != inputHash or
+           result.numExpressions() != Indexer.size() or
+           result.numPoints() != (int)program.CFG.size())
+            return false;
+
+        result.readPartitions(Partitions);
+        ClosureSignature.assign(program.CFG.size(), 0);
+
+        Parent.clear();
+        result.forEachParent([&](uint64_t key, int setId) { Parent.assign(key, setId); });
+        SetCnt = LiveSetCnt = result.setCnt();
+
+        Counters.Iterations = result.iterations(), Counters.Transfers = result.transfers();
+        Counters.Confluences = result.confluences();
+        return true;
+    }
+
+    /**
+     * @brief
+     *  Hash of the parsed program and of the options its result 
+     *  depends on, which keys the cache of results.
+     *
+     * @details
+     *  The program is hashed as the constants and variables in the
+     *  order they are indexed, followed by each instruction along
+     *  with its predecessors, so a change in the layout of the 
+     *  program text which does not change the parsed program does
+     *  not change the hash.
+     *
+     * @return      The hash.
+     *
+     * @see CacheDir, readResult
+     **/
+    uint64_t inputHash() {
+        std::ostringstream text;
+        text << ResultFormat::Version << ' ' << SparseMode << ' ' << Wavefront << ' '
+             << CompactThreshold << " [";
+        for(char op : Ops) text << op;
+        text << "]\n";
+
+        CustomOStream textOut(program, text);
+        for(int i = 0; i < (int)program.Constants.size(); i++) textOut << program.Constants[i] << ' ';
+        textOut << '\n';
+        for(int i = 0; i < (int)program.Variables.size(); i++) textOut << program.Variables[i] << ' ';
+        textOut << '\n';
+
+        int instCnt = program.Instructions.size();
+        for(int i = 0; i < instCnt; i++) {
+            auto &inst = program.Instructions[i];
+            if(i != 0 and i != instCnt - 1) textOut << inst;
+            textOut << " <-";
+            for(int pred : inst.predecessors) textOut << ' ' << pred;
+            textOut << '\n';
+        }
+
+        return ResultFormat::hashString(text.str());
+    }
+};
+
+#endif
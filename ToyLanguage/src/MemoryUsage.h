@@ -0,0 +1,114 @@
+/**
+ * @file MemoryUsage.h
+ *  This file defines the accounting of the memory taken by the
+ *  analysis: the bytes held by each of its data structures and the
+ *  resident memory of the process at the end of each phase, and the
+ *  error raised when the analysis would go over a memory budget.
+ **/
+
+#ifndef MEMORYUSAGE_H
+#define MEMORYUSAGE_H
+
+#include<cstdio>
+#include<ostream>
+#include<stdexcept>
+#include<string>
+#include<vector>
+#include<sys/resource.h>
+#include<unistd.h>
+
+/**
+ * @brief
+ *  Returns the resident memory of the process in bytes, 0 if it
+ *  cannot be read.
+ **/
+size_t residentMemory() {
+    FILE *file = fopen("/proc/self/statm", "r");
+    if(not file) return 0;
+
+    // the second field is the number of resident pages
+    unsigned long size = 0, resident = 0;
+    bool read = (fscanf(file, "%lu %lu", &size, &resident) == 2);
+    fclose(file);
+    return read ? resident * (size_t)sysconf(_SC_PAGESIZE) : 0;
+}
+
+/**
+ * @brief   Returns the peak resident memory of the process in bytes.
+ **/
+size_t peakResidentMemory() {
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+    return (size_t)usage.ru_maxrss * 1024;
+}
+
+/**
+ * @brief
+ *  Bytes held by the data structures of the analysis and resident
+ *  memory of the process at the end of a phase.
+ *
+ * @details
+ *  The bytes are those allocated by the containers, without the
+ *  overhead of `malloc`, so they add up to less than the resident
+ *  memory.
+ **/
+struct MemorySnapshotTy {
+    /**
+     * @brief   Phase after which the snapshot is taken.
+     **/
+    std::string Phase;
+
+    /**
+     * @brief
+     *  Bytes held by the partitions, by `Parent`, by the expression
+     *  indexer along with `UsedBy`, by the control flow graph and by
+     *  the constants, variables and instructions of the program.
+     **/
+    size_t Partitions = 0, Parent = 0, Indexer = 0, CFG = 0, Program = 0;
+
+    /**
+     * @brief   Resident and peak resident memory of the process.
+     **/
+    size_t Rss = 0, PeakRss = 0;
+};
+
+/**
+ * @brief
+ *  Prints snapshots of the memory as a table, in kilobytes.
+ *
+ * @param   os          Stream to print to
+ * @param   snapshots   Snapshots, in the order they were taken
+ * @returns     Void
+ **/
+void printMemoryReport(std::ostream &os, std::vector<MemorySnapshotTy> const &snapshots) {
+    char line[256];
+    snprintf(line, sizeof(line), "%-24s %12s %12s %12s %12s %12s %12s %12s\n", "Phase (KB)",
+             "Partitions", "Parent", "Indexer", "CFG", "Program", "RSS", "Peak RSS");
+    os << line;
+    for(auto &el : snapshots) {
+        snprintf(line, sizeof(line), "%-24s %12zu %12zu %12zu %12zu %12zu %12zu %12zu\n",
+                 el.Phase.c_str(), el.Partitions / 1024, el.Parent / 1024, el.Indexer / 1024,
+                 el.CFG / 1024, el.Program / 1024, el.Rss / 1024, el.PeakRss / 1024);
+        os << line;
+    }
+}
+
+/**
+ * @brief
+ *  Error thrown when the analysis would go over its memory budget.
+ **/
+class MemoryBudgetError : public std::runtime_error {
+public:
+    /**
+     * @brief   Constructor for MemoryBudgetError class.
+     *
+     * @param   phase   Phase in which the budget would be exceeded
+     * @param   bytes   Memory which would be used
+     * @param   budget  Memory budget
+     **/
+    MemoryBudgetError(std::string const &phase, size_t bytes, size_t budget) :
+        std::runtime_error("Memory budget of " + std::to_string(budget >> 20) + " MB exceeded in " +
+                           phase + " (" + std::to_string(bytes >> 20) + " MB)") {}
+};
+
+#endif
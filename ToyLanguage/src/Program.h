@@ -7,19 +7,22 @@
 #ifndef PROGRAM_H
 #define PROGRAM_H
 
+#include<algorithm>
 #include<cassert>
-#include<fstream>
+#include<charconv>
 #include<iostream>
 #include<set>
-#include<sstream>
 #include<string>
+#include<string_view>
 #include<queue>
-#include"MapVector.h"
+#include<vector>
+#include"InternMapVector.h"
+#include"SourceFile.h"
 
-// simple macro to print a header line to standard output
+// simple macro to print a header line to an output stream
 #ifndef PRINT_HEADER
-#define PRINT_HEADER(str) std::cout << std::string(100, '=') << '\n' << (str) \
-                                    << '\n' << std::string(100, '=') << '\n';
+#define PRINT_HEADER(os, str) (os) << std::string(100, '=') << '\n' << (str) \
+                                   << '\n' << std::string(100, '=') << '\n';
 #endif
 
 // forward declaration of `Program` class. This is required because 
@@ -42,13 +45,19 @@ struct CustomOStream {
      **/
     Program &program;
 
+    /**
+     * @brief   The output stream to which everything is written
+     **/
+    std::ostream &os;
+
     /**
      * @brief   Constructor for the structure
      * 
      * @param   program Program object over which the new object is to
      *                  be parameterised
+     * @param   os      Output stream to write to
      **/
-    CustomOStream(Program &program) : program(program) {}
+    CustomOStream(Program &program, std::ostream &os) : program(program), os(os) {}
 };
 
 /**
@@ -204,6 +213,15 @@ public:
          **/
         std::vector<int> predecessors;
 
+        /**
+         * @brief
+         *  Index of successor control flow nodes as given
+         *  by `Program::CFG`.
+         *
+         * @see Program::CFG
+         **/
+        std::vector<int> successors;
+
         /**
          * @brief
          *  Index of the instruction which this node represents
@@ -221,29 +239,29 @@ public:
      * @brief Variables used in the program.
      * 
      * @details
-     *  It is a `MapVector` object which maps variable
+     *  It is an `InternMapVector` object which maps variable
      *  names to unique integers, so that we finally
      *  have to work only with integers instead of
-     *  working with strings. Also `MapVector` maps
+     *  working with strings. Also `InternMapVector` maps
      *  unique strings to unique integers, which also
      *  helps to identify same variable used at different
      *  places.
      * 
-     * @see MapVector
+     * @see InternMapVector
      **/
-    MapVector<std::string> Variables;
+    InternMapVector<std::string> Variables;
 
     /**
      * @brief Constants used in the program.
      * 
      * @details
-     *  It is a `MapVector` object which maps unique integers
+     *  It is an `InternMapVector` object which maps unique integers
      *  to new unique integers. The new mapped integers are
      *  used to while working with the program.
      * 
-     * @see MapVector
+     * @see InternMapVector
      **/
-    MapVector<int> Constants;
+    InternMapVector<int> Constants;
 
     /**
      * @brief Instructions in the program.
@@ -283,8 +301,11 @@ public:
 
     /**
      * @brief Constructor for Program class
+     * 
+     * @param   os  Output stream to which the program is printed,
+     *              standard output by default
      **/
-    Program() : cout(*this) {}
+    Program(std::ostream &os = std::cout) : cout(*this, os) {}
 
     /**
      * @brief
@@ -299,7 +320,59 @@ public:
 
     /**
      * @brief
-     *  Prints the program to standard output in a readable format.
+     *  Parses an assignment instruction, adding the constants and
+     *  variables it uses to `Constants` and `Variables`.
+     * 
+     * @param   text    Text of the instruction
+     * @return  The instruction
+     * 
+     * @see Constants, InstructionTy, Variables
+     **/
+    InstructionTy parseInstruction(std::string_view text);
+
+    /**
+     * @brief
+     *  Checks that a text is an assignment instruction which
+     *  `parseInstruction` accepts, without changing the program.
+     * 
+     * @param   text    Text of the instruction
+     * @param   ops     Operators the instruction may use
+     * @return  Empty if the text is an instruction, otherwise what
+     *          is wrong with it
+     * 
+     * @see parseInstruction
+     **/
+    static std::string checkInstruction(std::string_view text, std::vector<char> const &ops);
+
+    /**
+     * @brief
+     *  Reads a token as an integer constant, like `std::stoi`.
+     * 
+     * @param   token   The token
+     * @param   value   Set to the constant, if the token is one
+     * @return  `std::errc()` if the token is a constant,
+     *          `std::errc::result_out_of_range` if it is a constant
+     *          which does not fit in an `int`, otherwise 
+     *          `std::errc::invalid_argument`
+     **/
+    static std::errc readConstant(std::string_view token, int &value);
+
+    /**
+     * @brief
+     *  Finds the constant or variable named by a token, adding it
+     *  to `Constants` or `Variables` if it is new.
+     * 
+     * @param   token   The token, a constant if it is read as an
+     *                  integer by `std::stoi` otherwise a variable
+     * @return  The constant or variable
+     * 
+     * @see Constants, Variables
+     **/
+    ValueTy parseValue(std::string_view token);
+
+    /**
+     * @brief
+     *  Prints the program to its output stream in a readable format.
      * 
      * @return  None
      **/
@@ -323,6 +396,29 @@ public:
      * @return  None
      **/
     void printCFG();
+
+    /**
+     * @brief
+     *  Returns the number of bytes allocated for the constants,
+     *  variables and instructions of the program.
+     *
+     * @details
+     *  The nodes of the sets of predecessors are counted by an
+     *  estimate of their size, as `std::set` does not expose it.
+     *
+     * @return  The bytes held by `Constants`, `Variables` and
+     *          `Instructions`
+     **/
+    size_t memoryUsage() const;
+
+    /**
+     * @brief
+     *  Returns the number of bytes allocated for the control flow
+     *  graph.
+     *
+     * @return  The bytes held by `CFG`
+     **/
+    size_t cfgMemoryUsage() const;
 };
 
 /** 
@@ -353,23 +449,23 @@ bool operator<(Program::ExpressionTy const &first,
 }
 
 CustomOStream& operator<<(CustomOStream &os, char ch) {
-    std::cout << ch;
+    os.os << ch;
     return os;
 }
 
 CustomOStream& operator<<(CustomOStream &os, int i) {
-    std::cout << i;
+    os.os << i;
     return os;
 }
 
-CustomOStream& operator<<(CustomOStream &os, std::string s) {
-    std::cout << s;
+CustomOStream& operator<<(CustomOStream &os, std::string_view s) {
+    os.os << s;
     return os;
 }
 
 CustomOStream& operator<<(CustomOStream &os, Program::ValueTy const &v) {
-    if(v.isConst) std::cout << os.program.Constants[v.index];
-    else std::cout << os.program.Variables[v.index];
+    if(v.isConst) os.os << os.program.Constants[v.index];
+    else os.os << os.program.Variables[v.index];
     return os;
 }
 
@@ -383,158 +479,255 @@ CustomOStream& operator<<(CustomOStream &os, Program::InstructionTy const &i) {
     return os << i.lValue << " = " << i.rValue;
 }
 
+/**
+ * @brief
+ *  Finds the constant or variable named by a token, adding it to
+ *  `Constants` or `Variables` if it is new.
+ * 
+ * @param   token   The token, a constant if it is read as an integer
+ *                  by `std::stoi` otherwise a variable
+ * @return  The constant or variable
+ * 
+ * @see Constants, Variables
+ **/
+Program::ValueTy Program::parseValue(std::string_view token) {
+    int constVal;
+    std::errc ec = readConstant(token, constVal);
+    if(ec != std::errc::invalid_argument) {
+        assert(ec == std::errc() && "Constant out of range");
+        return {true, Constants.insert(constVal).first};
+    }
+    return {false, Variables.insert(token).first};
+}
+
+/**
+ * @brief
+ *  Reads a token as an integer constant, like `std::stoi`.
+ * 
+ * @param   token   The token
+ * @param   value   Set to the constant, if the token is one
+ * @return  `std::errc()` if the token is a constant,
+ *          `std::errc::result_out_of_range` if it is a constant
+ *          which does not fit in an `int`, otherwise 
+ *          `std::errc::invalid_argument`
+ **/
+std::errc Program::readConstant(std::string_view token, int &value) {
+    // like `std::stoi`, an optional sign followed by digits is read
+    // as an integer and anything after the digits is ignored
+    char const *begin = token.data(), *end = token.data() + token.size();
+    if(token.size() > 1 and token[0] == '+' and token[1] != '-') begin++;
+    return std::from_chars(begin, end, value).ec;
+}
+
+/**
+ * @brief Parses an assignment instruction.
+ * 
+ * @param   text    Text of the instruction
+ * @return  The instruction, with `reachable` and `cfgIndex` set to
+ *          false and -1 and no predecessors
+ * 
+ * @see Constants, Variables
+ **/
+Program::InstructionTy Program::parseInstruction(std::string_view text) {
+    ValueTy lValue, leftOp, rightOp;
+    char op = '\0';
+
+    // ideally lvalue should be a variable (a string that does
+    // not starts with a digit)
+    lValue = parseValue(nextToken(text));
+    assert(!lValue.isConst && "LValue is not a variable");
+
+    // read and ignore the `=` in the instruction
+    std::string_view in = nextToken(text);
+    assert(in == "=" && "No RValue specified");
+
+    // read the first operand from the instruction
+    in = nextToken(text);
+    assert(!in.empty() && "No RValue specified");
+
+    // store left operand of rvalue of current instruction
+    if(in == "*") op = '#', leftOp = {false, -1};
+    else leftOp = parseValue(in);
+
+    // read the next token in the instruction (which should be the
+    // operator if any)
+    in = nextToken(text);
+
+    // if the current instruction is non-deterministic assignment
+    // then it can not have a second operand. Note that if the 
+    // rvalue is non-deterministic only then `op` has value `#`.
+    assert((op != '#' || in.empty()) && "Invalid instruction");
+
+    if(!in.empty()) {
+        // if the current instruction has rvalue, which is two 
+        // length expression
+
+        // determine the operator and check if it is valid.
+        // If the operator is invalid then op will have value 
+        // '\0', by which it was initialised
+        if(in.length() == 1) {
+            switch(in[0]) {
+                case '+':
+                case '-':
+                case '*':
+                case '/': op = in[0];
+            }
+        }
+        assert(op != '\0' && "Invalid operand");
+
+        // read the second operand from the instruction
+        in = nextToken(text);
+        assert(!in.empty() && "Second operand not specified");
+
+        // store right operand of rvalue of current instruction
+        rightOp = parseValue(in);
+    } else {
+        // if rvalue is not two length expression, a default value
+        // value for right operand for consistency
+        rightOp = {false, -1};
+    }
+
+    return {lValue, {op, leftOp, rightOp}, false, -1, {}};
+}
+
+/**
+ * @brief
+ *  Checks that a text is an assignment instruction which
+ *  `parseInstruction` accepts, without changing the program.
+ * 
+ * @details
+ *  The checks are those of the assertions in `parseInstruction`,
+ *  and besides the operator must be one of `ops` and nothing may
+ *  follow the instruction.
+ * 
+ * @param   text    Text of the instruction
+ * @param   ops     Operators the instruction may use
+ * @return  Empty if the text is an instruction, otherwise what is
+ *          wrong with it
+ * 
+ * @see parseInstruction
+ **/
+std::string Program::checkInstruction(std::string_view text, std::vector<char> const &ops) {
+    int constVal;
+    auto checkValue = [&](std::string_view token) -> std::string {
+        if(readConstant(token, constVal) == std::errc::result_out_of_range)
+            return "the constant " + std::string(token) + " is out of range";
+        return "";
+    };
+
+    std::string_view lValue = nextToken(text);
+    if(lValue.empty()) return "the instruction is empty";
+    if(readConstant(lValue, constVal) != std::errc::invalid_argument)
+        return "the lvalue " + std::string(lValue) + " is not a variable";
+
+    if(nextToken(text) != "=") return "no = after the lvalue";
+    std::string_view leftOp = nextToken(text);
+    if(leftOp.empty()) return "no rvalue after =";
+    std::string_view op = nextToken(text);
+    if(leftOp == "*") {
+        if(not op.empty()) return "a non-deterministic assignment has a single operand";
+        return "";
+    }
+    if(std::string error = checkValue(leftOp); not error.empty()) return error;
+    if(op.empty()) return "";
+
+    if(op.length() != 1 or std::string_view("+-*/").find(op[0]) == std::string_view::npos)
+        return "invalid operator " + std::string(op);
+    if(std::find(ops.begin(), ops.end(), op[0]) == ops.end())
+        return "the operator " + std::string(op) + " is not one of the operators analysed";
+    std::string_view rightOp = nextToken(text);
+    if(rightOp.empty()) return "no second operand after " + std::string(op);
+    if(std::string error = checkValue(rightOp); not error.empty()) return error;
+
+    std::string_view rest = nextToken(text);
+    if(not rest.empty()) return "unexpected " + std::string(rest) + " after the instruction";
+    return "";
+}
+
 /**
  * @brief Parses and captures a program.
  * 
+ * @details
+ *  The file is mapped into memory and split into lines and tokens
+ *  in place. Identifiers are looked up in hash tables as views of
+ *  the text, so only the first occurrence of each variable or label
+ *  is copied.
+ * 
  * @param   fname   Filename which contains the program text
  * @return  None  
  * 
  * @see Constants, Instructions, Variables
  **/
 void Program::parse(std::string fname) {
-    std::ifstream fin(fname);
-    assert(fin && "Error opening file");
+    SourceFile file;
+    bool opened = file.open(fname);
+    assert(opened && "Error opening file");
+    (void)opened;
 
     // keeps count of the current instruction number. It is 
     // initialised 1 because 0th instruction is the dummy START
     // instruction
     int instCnt = 1;
 
-    // holds a program line
-    std::string buf;
+    // text remaining to be read and the current program line
+    std::string_view text = file.text(), buf;
+
+    // names of the labels, used and defined, and the instruction
+    // index each one refers to (-1 until it is defined)
+    InternMapVector<std::string> labelNames;
+    std::vector<int> labels;
 
     // holds jump labels for instructions corresponding to their indexes.
     // If `jumps` vector is empty for an instruction, it means a default
     // jump to the instruction corresponding to the next index
-    std::vector<std::vector<std::string>> jumps;
-
-    // holds the instruction indexes to which the labels refer to
-    std::map<std::string, int> labels;
+    std::vector<std::vector<int>> jumps;
 
     // updating `jumps` and `Program::Instructions` for START instruction
     InstructionTy dummy = {{false, -1}, {'\0', {false, -1}, {false, -1}}, false, {}};
     Instructions.emplace_back(dummy);
-    jumps.emplace_back(std::vector<std::string>());
+    jumps.emplace_back(std::vector<int>());
 
     // read the program, processing each instruction type and checking
     // the validity. The jumps can not be resolved at this stage (before
     // the whole program is processed), as labels can be used before
     // definitions
-    while(getline(fin, buf)) {
-        // ignores empty lines in the program text
-        if(buf.empty()) continue;
-
-        // buffer holding current instruction
-        std::stringstream ss(buf);
-        
-        // holds the tokens in the instruction while they are processed
-        // in succession 
-        std::string in;
-
-        // read the first token in the instruction
-        ss >> in;
+    while(nextLine(text, buf)) {
+        // read the first token in the instruction, ignoring empty lines
+        // in the program text
+        std::string_view line = buf, in = nextToken(line);
+        if(in.empty()) continue;
 
         if(in == "GOTO") {
-            while(ss >> in)
-                jumps[instCnt - 1].push_back(in);
+            while(not (in = nextToken(line)).empty()) {
+                auto label = labelNames.insert(in);
+                if(label.second) labels.push_back(-1);
+                jumps[instCnt - 1].push_back(label.first);
+            }
         } else if(in == "LABEL") {
             // current instruction defines a label
-            while(ss >> in) {
-                assert(labels.find(in) == labels.end() && "Duplicate label found");
-                labels[in] = instCnt;
+            while(not (in = nextToken(line)).empty()) {
+                auto label = labelNames.insert(in);
+                if(label.second) labels.push_back(-1);
+                assert(labels[label.first] == -1 && "Duplicate label found");
+                labels[label.first] = instCnt;
             }
         } else {
             // current instruction is an assignment instruction
-
-            int constVal;
-            ValueTy lValue, leftOp, rightOp;
-            char op = '\0';
-            
-            try { 
-                // ideally lvalue should be a variable (a string that does
-                // not starts with a digit). So this must throw an exception 
-                // and we should reach catch block.
-                constVal = std::stoi(in.c_str()); 
-
-                assert(false && "LValue is not a variable");
-            } catch(std::invalid_argument) {
-                // storing lvalue of current instruction       
-                lValue = {false, Variables.insert(in).first};
-
-                // read and ignore the `=` in the instruction buffer
-                in.clear(), ss >> in;
-                assert(in == "=" && "No RValue specified");
-
-                // read the first operand from the instruction buffer
-                in.clear(), ss >> in;
-                assert(!in.empty() && "No RValue specified");
-
-                // store left operand of rvalue of current instruction
-                try {
-                    constVal = std::stoi(in.c_str());
-                    leftOp = {true, Constants.insert(constVal).first};
-                } catch(std::invalid_argument) {
-                    if(in == "*") op = '#', leftOp = {false, -1};
-                    else leftOp = {false, Variables.insert(in).first};
-                }
-
-                // read the next token in the instruction buffer (which should
-                // be the operator if any)
-                in.clear(), ss >> in;
-
-                // if the current instruction is non-deterministic assignment
-                // then it can not have a second operand. Note that if the 
-                // rvalue is non-deterministic only then `op` has value `#`.
-                assert((op != '#' || in.empty()) && "Invalid instruction");
-
-                if(!in.empty()) {
-                    // if the current instruction has rvalue, which is two 
-                    // length expression
-
-                    // determine the operator and check if it is valid.
-                    // If the operator is invalid then op will have value 
-                    // '\0', by which it was initialised
-                    if(in.length() == 1) {
-                        switch(in[0]) {
-                            case '+':
-                            case '-':
-                            case '*':
-                            case '/': op = in[0];
-                        }
-                    }
-                    assert(op != '\0' && "Invalid operand");
-
-                    // read the second operand from the instruction buffer
-                    in.clear(), ss >> in;
-                    assert(!in.empty() && "Second operand not specified");
-
-                    // store right operand of rvalue of current instruction
-                    try {
-                        constVal = std::stoi(in.c_str());
-                        rightOp = {true, Constants.insert(constVal).first};
-                    } catch(std::invalid_argument) {
-                        rightOp = {false, Variables.insert(in).first};
-                    }
-                } else {
-                    // if rvalue is not two length expression, a default value
-                    // value for right operand for consistency
-                    rightOp = {false, -1};
-                }
-            }
+            InstructionTy inst = parseInstruction(buf);
 
             // push the current instruction in `Instructions` vector
             // at index `instCnt`. For now `reachable` and `cfgIndex`
             // fields are set to default value of false and -1. These
             // would be set to actual values later.
-            Instructions.push_back({lValue, {op, leftOp, rightOp}, false, -1, {}});
-            jumps.emplace_back(std::vector<std::string>());
+            Instructions.push_back(inst);
+            jumps.emplace_back(std::vector<int>());
             instCnt++;
         }
     }
 
     // updating `jumps` and `Program::Instructions` for END instruction
     Instructions.push_back(dummy);
-    jumps.emplace_back(std::vector<std::string>());
+    jumps.emplace_back(std::vector<int>());
     instCnt++;
 
     // now process the jumps as given by the labels. Reachability
@@ -552,18 +745,18 @@ void Program::parse(std::string fname) {
         if(not jumps[cur].empty()) {
             // process the jumps
             for(auto el : jumps[cur]) {
-                auto it = labels.find(el);
-                assert(it != labels.end() && "Undefined label found");
+                int target = labels[el];
+                assert(target != -1 && "Undefined label found");
 
                 // if the label points to index `instCnt`, it means
                 // the current instruction being processed is the dummy
                 // END instruction and this has to be ignored
-                if(it->second == instCnt) continue;
+                if(target == instCnt) continue;
 
-                Instructions[it->second].predecessors.insert(cur);
-                if(not Instructions[it->second].reachable) {
-                    Instructions[it->second].reachable = true;
-                    q.push(it->second);
+                Instructions[target].predecessors.insert(cur);
+                if(not Instructions[target].reachable) {
+                    Instructions[target].reachable = true;
+                    q.push(target);
                 }
             }
         } else {
@@ -581,25 +774,23 @@ void Program::parse(std::string fname) {
             }
         }
     }
-
-    fin.close();
 }
 
 /**
  * @brief
- *  Prints the program to standard output in a readable format.
+ *  Prints the program to its output stream in a readable format.
  * 
  * @return  None
  **/
 void Program::print() {
     // print all the variables
-    PRINT_HEADER("Variables");
+    PRINT_HEADER(cout.os, "Variables");
     for(auto &el : Variables)
         cout << el << ", ";
     cout << "\n\n";
 
     // print all the constants
-    PRINT_HEADER("Constants");
+    PRINT_HEADER(cout.os, "Constants");
     for(auto &el : Constants)
         cout << el << ", ";
     cout << "\n\n";
@@ -607,7 +798,7 @@ void Program::print() {
     // now print all the instructions, if they are
     // reachable print their predecessors else mark
     // them as unreachable
-    PRINT_HEADER("Input Program");
+    PRINT_HEADER(cout.os, "Input Program");
     
     int sz = Instructions.size();
     for(int i = 0; i < sz; i++) {
@@ -673,7 +864,7 @@ void Program::createCFG() {
     // for each instructions
     CFG.resize(cfgSize);
 
-    for(int i = 0; i < Instructions.size(); i++) {
+    for(int i = 0; i < (int)Instructions.size(); i++) {
         InstructionTy &I = Instructions[i];
 
         // ignore unreachable instructions
@@ -707,6 +898,11 @@ void Program::createCFG() {
             CFG[idx].instructionIndex = i;
         }
     }
+
+    // fill successors of each node from its predecessors
+    for(int i = 0; i < cfgSize; i++)
+        for(auto el : CFG[i].predecessors)
+            CFG[el].successors.push_back(i);
 }
 
 /**
@@ -717,7 +913,7 @@ void Program::createCFG() {
  * @return  None
  **/
 void Program::printCFG() {
-    PRINT_HEADER("Control Flow Graph");
+    PRINT_HEADER(cout.os, "Control Flow Graph");
 
     int cfgSize = CFG.size();
     for(int i = 0; i < cfgSize; i++) {
@@ -732,7 +928,7 @@ void Program::printCFG() {
             // instruction index (as given by `Instructions`),
             // the instruction itself and then the index of 
             // the predecssor control flow graph node
-            if(idx == Instructions.size() - 1) cout << "END";
+            if(idx == (int)Instructions.size() - 1) cout << "END";
             else cout << "Transfer Point => (" << idx << ") " 
                       << Instructions[idx];
                  
@@ -751,4 +947,37 @@ void Program::printCFG() {
     cout << "\n\n";
 }
 
+/**
+ * @brief
+ *  Returns the number of bytes allocated for the constants,
+ *  variables and instructions of the program.
+ *
+ * @return  The bytes held by `Constants`, `Variables` and
+ *          `Instructions`
+ **/
+size_t Program::memoryUsage() const {
+    // a node of `std::set<int>` holds three links, its colour and
+    // the value
+    size_t setNodeSize = 4 * sizeof(void *) + sizeof(int);
+
+    size_t bytes = Constants.memoryUsage() + Variables.memoryUsage() +
+                   Instructions.capacity() * sizeof(InstructionTy);
+    for(auto &el : Instructions) bytes += el.predecessors.size() * setNodeSize;
+    return bytes;
+}
+
+/**
+ * @brief
+ *  Returns the number of bytes allocated for the control flow
+ *  graph.
+ *
+ * @return  The bytes held by `CFG`
+ **/
+size_t Program::cfgMemoryUsage() const {
+    size_t bytes = CFG.capacity() * sizeof(CfgNodeTy);
+    for(auto &el : CFG)
+        bytes += (el.predecessors.capacity() + el.successors.capacity()) * sizeof(int);
+    return bytes;
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,150 @@
+/**
+ * @file SourceFile.h
+ *  This file defines a SourceFile class which maps the text of a
+ *  program into memory, and helpers splitting the text into lines
+ *  and tokens without copying it.
+ **/
+
+#ifndef SOURCEFILE_H
+#define SOURCEFILE_H
+
+#include<cassert>
+#include<fstream>
+#include<iterator>
+#include<string>
+#include<string_view>
+#include<fcntl.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+#include<unistd.h>
+
+/**
+ * @brief
+ *  Read only text of a file, mapped into memory.
+ *
+ * @details
+ *  Files which can not be mapped (empty files, pipes) are read into
+ *  a buffer instead, so the text is available either way.
+ **/
+class SourceFile {
+public:
+    SourceFile() : Data(nullptr), Size(0) {}
+    ~SourceFile() { close(); }
+
+    SourceFile(SourceFile const &) = delete;
+    SourceFile &operator=(SourceFile const &) = delete;
+
+    /**
+     * @brief   Method to map a file, closing any file mapped before.
+     *
+     * @param   fname   Name of the file
+     *
+     * @returns     False if the file could not be opened otherwise true
+     **/
+    bool open(std::string const &fname) {
+        close();
+
+        int fd = ::open(fname.c_str(), O_RDONLY);
+        if(fd < 0) return false;
+
+        struct stat st;
+        if(fstat(fd, &st) == 0 and S_ISREG(st.st_mode) and st.st_size > 0) {
+            void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if(data != MAP_FAILED) {
+                // the text is read once from the beginning to the end
+                madvise(data, st.st_size, MADV_SEQUENTIAL);
+                Data = (char const *)data, Size = st.st_size;
+            }
+        }
+        ::close(fd);
+        if(Data) return true;
+
+        std::ifstream fin(fname, std::ios::binary);
+        if(not fin) return false;
+        Buffer.assign(std::istreambuf_iterator<char>(fin), std::istreambuf_iterator<char>());
+        return true;
+    }
+
+    /**
+     * @brief   Method to unmap the file, if any.
+     **/
+    void close() {
+        if(Data) munmap((void *)Data, Size);
+        Data = nullptr, Size = 0;
+        Buffer.clear();
+    }
+
+    /**
+     * @brief
+     *  Method to return the text of the file, valid until the file
+     *  is closed.
+     **/
+    std::string_view text() const {
+        if(Data) return std::string_view(Data, Size);
+        return Buffer;
+    }
+
+private:
+    /**
+     * @brief   Beginning of the mapping, `nullptr` if there is none.
+     **/
+    char const *Data;
+
+    /**
+     * @brief   Size of the mapping in bytes.
+     **/
+    size_t Size;
+
+    /**
+     * @brief   Text of a file which could not be mapped.
+     **/
+    std::string Buffer;
+};
+
+/**
+ * @brief
+ *  Takes the next line out of a text.
+ *
+ * @param[in,out]   text    Text remaining, the line and its newline
+ *                          are removed from its beginning
+ * @param[out]      line    The line, without the newline
+ * @returns     False if the text was empty otherwise true
+ **/
+inline bool nextLine(std::string_view &text, std::string_view &line) {
+    if(text.empty()) return false;
+
+    size_t end = text.find('\n');
+    if(end == std::string_view::npos) {
+        line = text, text = std::string_view();
+    } else {
+        line = text.substr(0, end), text.remove_prefix(end + 1);
+    }
+    return true;
+}
+
+/**
+ * @brief
+ *  Takes the next token, a maximal run of characters other than
+ *  whitespace, out of a line.
+ *
+ * @param[in,out]   line    Line remaining, the token and the
+ *                          whitespace before it are removed from its
+ *                          beginning
+ * @returns     The token, empty if there is none
+ **/
+inline std::string_view nextToken(std::string_view &line) {
+    auto isSpace = [](char ch) {
+        return ch == ' ' or ch == '\t' or ch == '\r' or ch == '\v' or ch == '\f';
+    };
+
+    size_t begin = 0, size = line.size();
+    while(begin < size and isSpace(line[begin])) begin++;
+    size_t end = begin;
+    while(end < size and not isSpace(line[end])) end++;
+
+    std::string_view token = line.substr(begin, end - begin);
+    line.remove_prefix(end);
+    return token;
+}
+
+#endif
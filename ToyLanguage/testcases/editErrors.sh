@@ -0,0 +1,45 @@
+#!/bin/bash
+# Checks that `--edit` rejects the indexes of START, END and of
+# instructions outside the program, and texts which are not
+# instructions, with an error (exit status 1) instead of crashing,
+# and still accepts the first and the last instruction. Run as
+#   ./editErrors.sh ../src/HerbrandEquivalence
+# The program of tc1 has the instructions 1 to 4, END being 5.
+
+# the binary is found relative to the current directory, or by
+# default in ../src relative to this script
+binary=${1:+$(realpath "$1")}
+cd "$(dirname "$0")"
+binary=${binary:-$(realpath ../src/HerbrandEquivalence)}
+program=$(mktemp)
+trap 'rm -f "$program"' EXIT
+sed -n '/^Toy Program/,$p' tc1 | tail -n +3 | sed '/^===/,$d' > "$program"
+
+failed=0
+check() {
+    local expected=$1; shift
+    "$binary" -v 0 "$@" "$program" > /dev/null 2>&1
+    local status=$?
+    if [ $status -ne $expected ]; then
+        echo "FAIL: $* exited with $status, expected $expected"
+        failed=1
+    fi
+}
+
+for index in -1 0 5 6 99 abc 1x; do
+    check 1 --edit "$index" "x = 1"
+    check 1 --sparse --edit "$index" "x = 1"
+done
+check 1 --edit 1 "x = 2" --edit 5 "x = 1"
+for text in "" "x =" "garbage" "1 = y" "x = y * z" "x = y % z" "x = y +" \
+            "x = * y" "x = y + z w" "x = 99999999999"; do
+    check 1 --edit 1 "$text"
+    check 1 --sparse --edit 1 "$text"
+done
+check 1 --edit 1 "x = 2" --edit 4 "x ="
+check 0 --edit 1 "x = 2"
+check 0 --edit 4 "y = x + 2"
+check 0 --edit 2 "z = *" --edit 3 "z = 7"
+
+[ $failed -eq 0 ] && echo "editErrors: OK"
+exit $failed